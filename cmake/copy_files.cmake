@@ -23,6 +23,7 @@ set(GENERATED_SRC
     ${ROSE_TOP_BINARY_DIR}/src/ROSETTA/src/Cxx_GrammarGetChildIndex.C
     ${ROSE_TOP_BINARY_DIR}/src/ROSETTA/src/Cxx_GrammarReturnDataMemberPointers.C  
     ${ROSE_TOP_BINARY_DIR}/src/ROSETTA/src/Cxx_GrammarRTI.C
+    ${ROSE_TOP_BINARY_DIR}/src/ROSETTA/src/Cxx_GrammarAstFileIO.C
     )
 #Copy the generated files to ${BUILD_DIR}/src/frontend/SageIII
 foreach (src ${GENERATED_HEADERS} ${GENERATED_SRC})
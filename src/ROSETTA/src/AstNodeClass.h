@@ -292,6 +292,12 @@ class AstNodeClass
   std::string buildChildIndex ();
   std::string buildListIteratorStringForChildIndex(std::string typeName, std::string variableName, std::string classNameString);
 
+// Support for the binary AST file I/O (see AST_FILE_IO.h): bodies of serializeDataMembers(),
+// serializeStaticDataMembers() and the member initializers of the AST file reader's constructor.
+  std::string buildAstFileIODataMembers();
+  std::string buildAstFileIOStaticDataMembers();
+  std::string buildAstFileIOConstructorInitializers();
+
   virtual void show(size_t indent = 0) const;
 
   void consistencyCheck() const;
@@ -353,6 +353,9 @@ class Grammar
        // DQ (3/7/2007): support for getChildIndex member function
           Rose::StringUtility::FileWithLineNumbers buildStringForGetChildIndexSource ( AstNodeClass & node );
 
+       // Support for the binary AST file I/O (AST_FILE_IO.h)
+          Rose::StringUtility::FileWithLineNumbers buildStringForAstFileIOSource ( AstNodeClass & node );
+
           bool buildConstructorParameterList ( AstNodeClass & node, 
                                                std::vector<GrammarString *> & constructorParameterList,
                                                ConstructParamEnum config );
@@ -407,6 +410,9 @@ class Grammar
        // DQ (3/7/2007): support for getChildIndex member function
           void buildStringForGetChildIndexSupport( AstNodeClass & node, Rose::StringUtility::FileWithLineNumbers & outputFile );
 
+       // Support for the binary AST file I/O (AST_FILE_IO.h)
+          void buildStringForAstFileIOSupport( AstNodeClass & node, Rose::StringUtility::FileWithLineNumbers & outputFile );
+
        // Uses list of targets and sources stored within each node to drive substitutions
           Rose::StringUtility::FileWithLineNumbers editSubstitution ( AstNodeClass & node, const Rose::StringUtility::FileWithLineNumbers& editString );
 
@@ -540,6 +546,9 @@ class Grammar
        // AS: build the funtion to automatically generate the memory pool based traversal on VariantVectors
           std::string buildMemoryPoolBasedVariantVectorTraversalSupport();
 
+       // Builds AST_FILE_IO::createEmptyNode(), AST_FILE_IO::serializeStaticDataMembers() and AST_FILE_IO::grammarSignature()
+          std::string buildAstFileIOVariantSupport();
+
        // MS: build VariantEnumnames 
           std::string buildVariantEnumNames();
 
@@ -0,0 +1,152 @@
+#ifndef UNPARSE_OUTPUT_SINK_H
+#define UNPARSE_OUTPUT_SINK_H
+
+// Output sinks for the generated code.
+//
+// UnparseFormat writes to a std::ostream (so that the unparser can still be pointed at any stream, e.g. a
+// std::ostringstream for unparseToString()), but the files generated by unparseFile() are written through an
+// UnparseOutputFile: its stream buffer accumulates the whole file in one contiguous block of memory that
+// UnparseFormat appends to directly (bypassing the iostream layer), and the file is written with a single
+// write(2) call (or through a memory mapping) when it is closed.
+//
+// In the patch output mode (-rose:unparser:patch_output, see patchUnparser.h) a file is instead written as an
+// UnparseOutputRope: spans of the original file (mapped read-only by an UnparseInputFile) interleaved with the code
+// regenerated for the modified statements, written with writev(2) without copying the spans.
+
+#include <cstddef>
+#include <deque>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! Stream buffer accumulating the output in one contiguous block of memory.
+class UnparseOutputBuffer : public std::streambuf
+   {
+     public:
+          UnparseOutputBuffer();
+
+       // Append text to the buffer (this is what UnparseFormat uses, it avoids the iostream layer).
+          void append ( const char* text, size_t length )
+             {
+               if (closed == false)
+                  {
+                    buffer.append(text,length);
+                  }
+             }
+
+          void append ( size_t count, char c )
+             {
+               if (closed == false)
+                  {
+                    buffer.append(count,c);
+                  }
+             }
+
+          const char* data() const { return buffer.data(); }
+          size_t size() const { return buffer.size(); }
+
+          void reserve ( size_t size ) { buffer.reserve(size); }
+
+       // Release the memory; text appended afterwards is discarded (as by a closed std::fstream).
+          void close();
+          bool is_closed() const { return closed; }
+
+     protected:
+          int_type overflow ( int_type c );
+          std::streamsize xsputn ( const char* text, std::streamsize length );
+
+       // Supports tellp().
+          pos_type seekoff ( off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode );
+
+     private:
+          std::string buffer;
+          bool closed;
+
+          UnparseOutputBuffer ( const UnparseOutputBuffer & X );
+          UnparseOutputBuffer & operator= ( const UnparseOutputBuffer & X );
+   };
+
+//! Output file of the unparser: the file is created when this is constructed and written when it is closed.
+class UnparseOutputFile : public std::ostream
+   {
+     public:
+          enum FlushMethod
+             {
+               e_write, //!< write(2) the buffer
+               e_mmap   //!< copy the buffer into a shared memory mapping of the file
+             };
+
+       // Like std::fstream, this is in a failed state (!stream is true) if the file cannot be created.
+          UnparseOutputFile ( const std::string & filename, FlushMethod method = e_write );
+         ~UnparseOutputFile();
+
+          bool is_open() const;
+
+       // Write the file and close it; the stream is in a failed state afterwards if the file could not be written.
+          void close();
+
+          UnparseOutputBuffer* buffer() { return &outputBuffer; }
+
+     private:
+          bool writeFile();
+          bool mapFile();
+
+          UnparseOutputBuffer outputBuffer;
+          std::string filename;
+          FlushMethod method;
+          int fileDescriptor;
+
+          UnparseOutputFile ( const UnparseOutputFile & X );
+          UnparseOutputFile & operator= ( const UnparseOutputFile & X );
+   };
+
+//! Read-only memory mapping of an input file (read into memory where it cannot be mapped).
+class UnparseInputFile
+   {
+     public:
+       // is_open() is false if the file cannot be read.
+          UnparseInputFile ( const std::string & filename );
+         ~UnparseInputFile();
+
+          bool is_open() const { return opened; }
+
+          const char* data() const { return text; }
+          size_t size() const { return length; }
+
+     private:
+          const char* text;
+          size_t length;
+          bool opened;
+          bool mapped;
+          std::string contents;
+
+          UnparseInputFile ( const UnparseInputFile & X );
+          UnparseInputFile & operator= ( const UnparseInputFile & X );
+   };
+
+//! Output assembled from pieces: spans of memory owned elsewhere (e.g. by an UnparseInputFile, which must stay open
+//! until the rope is written) and text fragments owned by the rope.
+class UnparseOutputRope
+   {
+     public:
+          UnparseOutputRope();
+
+       // The span is not copied; a span following the previous one in memory extends it.
+          void appendSpan ( const char* text, size_t length );
+          void appendFragment ( const std::string & text );
+
+          size_t size() const { return length; }
+          size_t numberOfPieces() const { return pieces.size(); }
+
+       // Create (or truncate) the file and write the pieces with writev(2), in as few calls as IOV_MAX allows.
+          bool write ( const std::string & filename ) const;
+
+     private:
+          std::vector<std::pair<const char*,size_t> > pieces;
+          std::deque<std::string> fragments;
+          size_t length;
+   };
+
+#endif
@@ -18,6 +18,11 @@ class Unparser;
 #define KAI_NONSTD_IOSTREAM 1
 // #include IOSTREAM_HEADER_FILE
 #include <iostream>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#include "unparseOutputSink.h"
 
 // DQ (1/26/2009): a value of 1000 is too small for Fortran code (see test2009_09.f; from Bill Henshaw)
 // This value is now increased to 1,000,000.  If this is too small then likely we want to
@@ -73,8 +78,18 @@ class UnparseFormat
      int indentstop;    //! the number of spaces allowed for indenting
      SgLocatedNode* prevnode; //! The previous SgLocatedNode unparsed
      std::ostream* os;  //! the directed output for the current file
+     UnparseOutputBuffer* sink; //! the buffer of os if it is an UnparseOutputFile (else NULL)
      UnparseFormatHelp *formatHelpInfo;
 
+  // Output text that is already formatted (appended to the sink directly when there is one).
+     void emit(const char* text, size_t length)
+        {
+          if (sink != NULL)
+               sink->append(text,length);
+            else
+               os->write(text,length);
+        }
+
   // void insert_newline(int i = 1, int indent = -1);
      void insert_space(int);
 
@@ -85,7 +100,12 @@ class UnparseFormat
 
      public:
 
-          UnparseFormat& operator << (std::string out);
+          UnparseFormat& operator << (const std::string & out);
+          UnparseFormat& operator << (const char* out);
+#if __cplusplus >= 201703L
+          UnparseFormat& operator << (std::string_view out);
+#endif
+          UnparseFormat& write (const char* text, size_t length);
           UnparseFormat& operator << (int num);
           UnparseFormat& operator << (short num);
           UnparseFormat& operator << (unsigned short num);
@@ -144,6 +164,27 @@ class UnparseFormat
 
        // DQ (9/30/2013): We need access to the std::ostream* os so that we can support token output without interpretation of line endings.
          std::ostream* output_stream () { return os; }
+
+       // Snapshot of the formatting state, used by the parallel unparser (see parallelUnparser.h) to check that text
+       // rendered by another UnparseFormat started in the state this one is in.
+          struct State
+             {
+               int currentLine;
+               int currentIndent;
+               int chars_on_line;
+               int stmtIndent;
+               int linewrap;
+               SgLocatedNode* prevnode;
+
+            // Everything except the line number (which does not change how the text is formatted).
+               bool sameFormattingAs ( const State & X ) const;
+             };
+
+          State get_state() const;
+
+       // Output text that was formatted starting in state start and ending in state end, and continue from end
+       // (the line number is advanced by the number of lines in the text).
+          void splice ( const std::string & text, const State & start, const State & end );
    };
 
 #endif
@@ -38,7 +38,7 @@ class Unparser_Nameq
          SgName lookup_generated_qualified_name ( SgNode* n );
 
       // DQ (3/14/2019): Adding debugging support to output the map of names.
-         void outputNameQualificationMap( const std::map<SgNode*,std::string> & qualifiedNameMap );
+         void outputNameQualificationMap( const SgNameQualificationMap & qualifiedNameMap );
 
    };
 
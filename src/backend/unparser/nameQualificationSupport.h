@@ -24,6 +24,10 @@
 // API function for new hidden list support.
 void generateNameQualificationSupport( SgNode* node, std::set<SgNode*> & referencedNameSet );
 
+// Requalify only the given function definitions of a file that has already been name qualified (see the incremental
+// name qualification in Unparser::computeNameQualification()).
+void generateNameQualificationSupport( SgSourceFile* file, const std::vector<SgFunctionDefinition*> & functionDefinitions, std::set<SgNode*> & referencedNameSet );
+
 class NameQualificationInheritedAttribute
    {
      private:
@@ -126,18 +130,18 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
        // to the static data members in SgNode, but this does not permit the proper handling of nexted types in 
        // templates since the unparser uses the SgNode static members directly.  so the switch to make this a 
        // reference fixes this problem.
-          std::map<SgNode*,std::string> & qualifiedNameMapForNames;
-          std::map<SgNode*,std::string> & qualifiedNameMapForTypes;
+          SgNameQualificationMap & qualifiedNameMapForNames;
+          SgNameQualificationMap & qualifiedNameMapForTypes;
 
        // DQ (9/7/2014): Modified to handle template header map (for template declarations).
-          std::map<SgNode*,std::string> & qualifiedNameMapForTemplateHeaders;
+          SgNameQualificationMap & qualifiedNameMapForTemplateHeaders;
 
        // DQ (6/3/2011): This is to save the names of types where they can be named differently when referenced 
        // from different locations in the source code.
-          std::map<SgNode*,std::string> & typeNameMap;
+          SgNameQualificationMap & typeNameMap;
 
        // DQ (3/13/2019): Adding support for name qualification of the many parts of more complex types such as template types.
-          std::map<SgNode*,std::map<SgNode*,std::string> > & qualifiedNameMapForMapsOfTypes;
+          SgNameQualificationMapOfMaps & qualifiedNameMapForMapsOfTypes;
 
        // DQ (1/24/2019): We need to accumulate the list of possible classes that are private base classes so 
        // that additional name qualification can be added to prevent the access of base classes that have been 
@@ -183,6 +187,45 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
           namespaceAliasMapType namespaceAliasDeclarationMap;
 #endif
 
+       // The name qualification of a declaration is evaluated again for every reference to it (typically many times
+       // from the same statement) and for the declarations of its enclosing scopes (once for each of their members),
+       // so the results of nameQualificationDepth() are memoized for the declaration, the current scope and the
+       // position of the reference.  A result is only valid for the declarations seen so far (referencedNameSet) and
+       // for the accumulated inaccessible base classes, the cache is cleared when these change.
+          struct NameQualificationDepthKey
+             {
+               SgDeclarationStatement* declaration;
+               SgScopeStatement*       currentScope;
+               SgStatement*            positionStatement;
+
+               bool operator== ( const NameQualificationDepthKey & X ) const
+                  {
+                    return declaration == X.declaration && currentScope == X.currentScope && positionStatement == X.positionStatement;
+                  }
+             };
+
+          struct NameQualificationDepthKeyHash
+             {
+               size_t operator() ( const NameQualificationDepthKey & key ) const
+                  {
+                    size_t h = std::hash<void*>()(key.declaration);
+                    h = h * 31 + std::hash<void*>()(key.currentScope);
+                    return h * 31 + std::hash<void*>()(key.positionStatement);
+                  }
+             };
+
+          std::unordered_map<NameQualificationDepthKey,int,NameQualificationDepthKeyHash> nameQualificationDepthCache;
+
+       // Size of the referencedNameSet (which only grows) when the cache was last known to be valid.
+          size_t nameQualificationDepthCacheReferencedNames;
+
+       // Evaluating a template instantiation also sets the name qualification of its template arguments (which are
+       // shared by all of the references to it), such results are not memoized so that this is done for each reference.
+          size_t numberOfTemplateArgumentEvaluations;
+
+          int computeNameQualificationDepth ( SgDeclarationStatement* declaration, SgScopeStatement* currentScope, SgStatement* positionStatement, bool forceMoreNameQualification );
+          void invalidateNameQualificationDepthCache();
+
      public:
        // DQ (4/3/2014): This map of sets is build once and then used to resolve when declarations have been
        // placed into scopes where they would permit name qualification (see test2014_32.C).
@@ -193,11 +236,11 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
        // HiddenListTraversal(SgNode* root);
 
        // DQ (9/7/2014): Modified to handle template header map (for template declarations).
-          NameQualificationTraversal(std::map<SgNode*,std::string> & input_qualifiedNameMapForNames,
-                                     std::map<SgNode*,std::string> & input_qualifiedNameMapForTypes,
-                                     std::map<SgNode*,std::string> & input_qualifiedNameMapForTemplateHeaders,
-                                     std::map<SgNode*,std::string> & input_typeNameMap,
-                                     std::map<SgNode*,std::map<SgNode*,std::string> > & input_qualifiedNameMapForMapsOfTypes, 
+          NameQualificationTraversal(SgNameQualificationMap & input_qualifiedNameMapForNames,
+                                     SgNameQualificationMap & input_qualifiedNameMapForTypes,
+                                     SgNameQualificationMap & input_qualifiedNameMapForTemplateHeaders,
+                                     SgNameQualificationMap & input_typeNameMap,
+                                     SgNameQualificationMapOfMaps & input_qualifiedNameMapForMapsOfTypes, 
                                      std::set<SgNode*> & input_referencedNameSet);
 
        // DQ (4/19/2019): When a type is the input we need the current statement as well, might want to require this uniformally.
@@ -328,14 +371,14 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
           void evaluateNameQualificationForTemplateArgumentList ( SgTemplateArgumentPtrList & templateArgumentList, SgScopeStatement* currentScope, SgStatement* positionStatement );
 
        // DQ (5/28/2011): Added support to set the global qualified name map.
-          const std::map<SgNode*,std::string> & get_qualifiedNameMapForNames() const;
-          const std::map<SgNode*,std::string> & get_qualifiedNameMapForTypes() const;
-          const std::map<SgNode*,std::string> & get_qualifiedNameMapForTemplateHeaders() const;
+          const SgNameQualificationMap & get_qualifiedNameMapForNames() const;
+          const SgNameQualificationMap & get_qualifiedNameMapForTypes() const;
+          const SgNameQualificationMap & get_qualifiedNameMapForTemplateHeaders() const;
 
        // DQ (3/13/2019): Adding support for name qualification to support multiple types that may be asociated with a 
        // single type used as a function return type (for example, always a template type containing multiple template 
        // arguments that require additional name qualification).
-          const std::map<SgNode*,std::map<SgNode*,std::string> > & get_qualifiedNameMapForMapsOfTypes() const;
+          const SgNameQualificationMapOfMaps & get_qualifiedNameMapForMapsOfTypes() const;
 
        // DQ (6/3/2011): Evaluate types to permit the strings representing unparsing the types 
        // are saved in a separate map associated with the IR node referencing the type.  This 
@@ -380,7 +423,7 @@ class NameQualificationTraversal : public AstTopDownBottomUpProcessing<NameQuali
           void displayBaseClassMap ( const std::string & label, BaseClassSetMap & x );
 
        // DQ (3/14/2019): Adding debugging support to output the map of names.
-          void outputNameQualificationMap( const std::map<SgNode*,std::string> & qualifiedNameMap );
+          void outputNameQualificationMap( const SgNameQualificationMap & qualifiedNameMap );
    };
 
 
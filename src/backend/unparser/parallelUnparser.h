@@ -0,0 +1,108 @@
+#ifndef PARALLEL_UNPARSER_H
+#define PARALLEL_UNPARSER_H
+
+// Support for the parallel unparser (-rose:unparser:jobs N).
+//
+// The declarations of the global scope of each C/C++ file are split into contiguous ranges (fragments) that are
+// rendered ahead of time, on worker threads, by separate Unparser objects writing to string buffers. All the files of
+// a file list are rendered at once, so both the files and the parts of large files are unparsed concurrently. The
+// files are then written as before, one at a time and in order, and unparseGlobalStmt() splices each fragment into the
+// output in place of unparsing its declarations again.
+//
+// A fragment is only spliced in if the UnparseFormat state recorded where it starts is the state the serial unparser
+// is in at that point; otherwise its declarations are unparsed serially. To make this the common case, the unparser
+// rendering a fragment starts with the declaration before it. The output is therefore byte-identical to the serial
+// unparser, and the line numbers tracked by UnparseFormat stay correct across the seams.
+
+#include <ios>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "unparse_format.h"
+
+class Unparser;
+class UnparseDelegate;
+class UnparseFormatHelp;
+
+//! Declarations [begin,end) of the global scope of a file, rendered ahead of time.
+class ParallelUnparseFragment
+   {
+     public:
+          ParallelUnparseFragment ( SgSourceFile* file, size_t begin, size_t end );
+
+       // Render the fragment (called on a worker thread).
+          void render();
+
+       // Called by unparseGlobalStmt() in the Unparser rendering the fragment.
+          size_t firstDeclarationToUnparse() const;
+          void recordStart ( Unparser* unp );
+          void recordEnd   ( Unparser* unp );
+
+          SgSourceFile* file;
+          size_t begin;
+          size_t end;
+
+       // The rendered text and the formatting state before and after it; complete is false if the fragment could not
+       // be rendered (or left compiler generated statements to be output by the declarations after it).
+          std::string text;
+          UnparseFormat::State startState;
+          UnparseFormat::State endState;
+          bool complete;
+
+     private:
+          std::streamoff startOffset;
+          std::streamoff endOffset;
+          bool startRecorded;
+          bool endRecorded;
+   };
+
+//! The fragments of one file, in order.
+class ParallelUnparseFileFragments
+   {
+     public:
+          ParallelUnparseFileFragments();
+
+       // Called by unparseGlobalStmt() in the Unparser writing the file: if the fragment starting at declaration index
+       // can be spliced in, output it and return the index of the declaration after it, else return index.
+          size_t splice ( size_t index, Unparser* unp );
+
+          std::vector<std::unique_ptr<ParallelUnparseFragment> > fragments;
+
+          size_t numberOfSplicedFragments;
+
+     private:
+          size_t nextFragment;
+   };
+
+//! Renders the global scopes of a list of files ahead of time (in the constructor) and makes the fragments available
+//! to unparseFile() until it is destroyed.
+class ParallelUnparser
+   {
+     public:
+       // 0 threads selects one per hardware thread.
+          ParallelUnparser ( const SgFilePtrList & files, UnparseFormatHelp* unparseHelp, UnparseDelegate* unparseDelegate, size_t numberOfThreads );
+         ~ParallelUnparser();
+
+       // The fragments of the file, or NULL if it was not rendered ahead of time.
+          static ParallelUnparseFileFragments* lookup ( SgFile* file );
+
+       // Files that use features relying on state shared between declarations or files are unparsed serially.
+          static bool canRenderAheadOfTime ( SgFile* file, UnparseFormatHelp* unparseHelp, UnparseDelegate* unparseDelegate );
+
+     private:
+          void buildFragments ( SgSourceFile* file, size_t numberOfThreads );
+
+          std::map<SgFile*,std::unique_ptr<ParallelUnparseFileFragments> > fileFragments;
+
+       // Enclosing instance, restored when this one is destroyed.
+          ParallelUnparser* previous;
+
+          static ParallelUnparser* current;
+
+          ParallelUnparser ( const ParallelUnparser & X );
+          ParallelUnparser & operator= ( const ParallelUnparser & X );
+   };
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef PATCH_UNPARSER_H
+#define PATCH_UNPARSER_H
+
+// Support for the patch output mode (-rose:unparser:patch_output).
+//
+// With the token-based unparsing (-rose:unparse_tokens) the generated file is the original file except where the AST
+// was changed. In the patch output mode such a file is written without unparsing the rest of it: the original file is
+// mapped read-only, each changed subtree is regenerated from the AST as a whole statement (the smallest enclosing
+// statement of a block, or block, that has its own token subsequence), and the output is written with a single
+// writev(2) of the original spans and the regenerated statements (see UnparseOutputRope). Generating the file then
+// takes time in proportion to the changes rather than to the file.
+//
+// Files whose changes cannot be confined to such statements (for example declarations added to or removed from the
+// global scope), or that use a feature of the unparser that keeps state across statements or files, are unparsed as
+// before. The token subsequences come from the frontend, so the original file must not have been changed since.
+
+#include <cstddef>
+#include <string>
+
+class UnparseDelegate;
+class UnparseFormatHelp;
+
+class PatchUnparser
+   {
+     public:
+       // Write the file to outputFilename in the patch output mode; returns false (without writing anything) if the
+       // file has to be unparsed as a whole.
+          static bool unparseFile ( SgFile* file, const std::string & outputFilename, UnparseFormatHelp* unparseHelp,
+                                    UnparseDelegate* unparseDelegate, SgScopeStatement* unparseScope );
+
+       // Files written in the patch output mode, and statements regenerated in them, so far.
+          static size_t numberOfPatchedFiles;
+          static size_t numberOfRegeneratedStatements;
+   };
+
+#endif
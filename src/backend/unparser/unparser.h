@@ -33,6 +33,10 @@
 
 class Unparser_Nameq;
 
+// Support for the parallel unparser (see parallelUnparser.h).
+class ParallelUnparseFragment;
+class ParallelUnparseFileFragments;
+
 // Macro used for debugging.  If true it fixes the anonymous typedef and anonymous declaration
 // bugs, but causes several other problems.  If false, everything works except the anonymous
 // typedef and anonymous declaration bugs.
@@ -77,6 +81,8 @@ class Unparser_Nameq;
 
 // void printOutComments ( SgLocatedNode* locatedNode );
 std::string get_output_filename( SgFile& file);
+//! returns the options used to unparse the file
+ROSE_DLL_API Unparser_Opt get_unparser_options( SgFile* file);
 //! returns the name of type t
 std::string get_type_name( SgType* t);
 
@@ -182,6 +188,11 @@ class Unparser
       //! be output after any statements attached to the next statements and before the next statement
           std::list<SgStatement*> compilerGeneratedStatementQueue;
 
+      //! Parallel unparser support (see parallelUnparser.h): the fragment of the global scope this unparser renders ahead
+      //! of time, or the fragments rendered ahead of time that are spliced into the file this unparser writes (else NULL).
+          ParallelUnparseFragment* parallelFragmentToRender;
+          ParallelUnparseFileFragments* parallelFragmentsToSplice;
+
    // DQ (5/8/2010): Switched this to be private.
       private:
        // DQ (12/5/2006): Output information that can be used to colorize properties of generated code (useful for debugging).
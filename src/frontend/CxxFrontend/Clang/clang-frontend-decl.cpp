@@ -379,7 +379,7 @@ SgNode * ClangToSageTranslator::Traverse(clang::Decl * decl) {
     if (decl == NULL)
         return NULL;
 
-    std::map<clang::Decl *, SgNode *>::iterator it = p_decl_translation_map.find(decl);
+    auto it = p_decl_translation_map.find(decl);
     if (it != p_decl_translation_map.end()) {
 #if DEBUG_TRAVERSE_DECL
         std::cerr << "Traverse Decl : " << decl << " ";
@@ -388,9 +388,12 @@ SgNode * ClangToSageTranslator::Traverse(clang::Decl * decl) {
         }
         std::cerr << " already visited : node = " << it->second << std::endl;
 #endif
+        if (p_visit_timing) countVisitHit("Decl", decl->getDeclKindName());
         return it->second;
     }
 
+    VisitTimer timer(*this, "Decl", decl->getDeclKindName());
+
     SgNode * result = NULL;
     bool ret_status = false;
 
@@ -1253,7 +1256,7 @@ bool ClangToSageTranslator::VisitRecordDecl(clang::RecordDecl * record_decl, SgN
 
     // CLANG FRONTEND FIX: Check if this decl was already translated (e.g., by template visitors)
     // This prevents creating duplicate SgClassDeclaration for nodes already handled as templates
-    std::map<clang::Decl*, SgNode*>::iterator it = p_decl_translation_map.find(record_decl);
+    auto it = p_decl_translation_map.find(record_decl);
     if (it != p_decl_translation_map.end()) {
 #if DEBUG_VISIT_DECL
         std::cerr << "VisitRecordDecl: Already translated, skipping: " << record_decl->getNameAsString() << std::endl;
@@ -1359,7 +1362,7 @@ bool ClangToSageTranslator::VisitRecordDecl(clang::RecordDecl * record_decl, SgN
         clang::Decl* context_decl = llvm::dyn_cast<clang::Decl>(decl_context);
         if (context_decl) {
             SgNode* context_node = NULL;
-            std::map<clang::Decl*, SgNode*>::iterator it = p_decl_translation_map.find(context_decl);
+            auto it = p_decl_translation_map.find(context_decl);
             if (it != p_decl_translation_map.end()) {
                 context_node = it->second;
                 SgNamespaceDefinitionStatement* ns_def = isSgNamespaceDefinitionStatement(context_node);
@@ -1818,7 +1821,7 @@ bool ClangToSageTranslator::VisitUsingDecl(clang::UsingDecl * using_decl, SgNode
             if (target != NULL) {
                 // Check if target was already translated
                 if (clang::Decl* target_decl = llvm::dyn_cast<clang::Decl>(target)) {
-                    std::map<clang::Decl *, SgNode *>::iterator it = p_decl_translation_map.find(target_decl);
+                    auto it = p_decl_translation_map.find(target_decl);
                     if (it != p_decl_translation_map.end()) {
                         // Try to cast to declaration or initialized name
                         sg_target_decl = isSgDeclarationStatement(it->second);
@@ -1880,7 +1883,7 @@ bool ClangToSageTranslator::VisitUsingDirectiveDecl(clang::UsingDirectiveDecl *
 
     if (clang_ns_decl != NULL) {
         // Check if namespace was already translated
-        std::map<clang::Decl *, SgNode *>::iterator it = p_decl_translation_map.find(clang_ns_decl);
+        auto it = p_decl_translation_map.find(clang_ns_decl);
         if (it != p_decl_translation_map.end()) {
             sg_ns_decl = isSgNamespaceDeclarationStatement(it->second);
         }
@@ -2262,7 +2265,7 @@ bool ClangToSageTranslator::VisitFunctionDecl(clang::FunctionDecl * function_dec
     if (decl_context && !decl_context->isTranslationUnit()) {
         clang::Decl* context_decl = llvm::dyn_cast<clang::Decl>(decl_context);
         if (context_decl) {
-            std::map<clang::Decl*, SgNode*>::iterator it = p_decl_translation_map.find(context_decl);
+            auto it = p_decl_translation_map.find(context_decl);
             if (it != p_decl_translation_map.end()) {
                 SgNode* context_node = it->second;
                 // Get the definition, not the declaration
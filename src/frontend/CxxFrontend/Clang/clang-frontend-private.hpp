@@ -4,6 +4,8 @@
 
 #include "clang-frontend.hpp"
 
+#include <chrono>
+
 #include "clang/AST/AST.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/ASTConsumer.h"
@@ -62,6 +64,7 @@
 
 #include "clang/Sema/Sema.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 
@@ -173,26 +176,57 @@ class ClangToSageTranslator : public clang::ASTConsumer {
         void setCompilerGeneratedFileInfo(SgNode * node, bool to_be_unparse = false);
 
     protected:
-        std::map<clang::Decl *, SgNode *> p_decl_translation_map;
-        std::map<clang::Stmt *, SgNode *> p_stmt_translation_map;
-        std::map<const clang::Type *, SgNode *> p_type_translation_map;
+        // Translated Clang nodes, consulted by every Traverse call (open addressing hash maps keyed by the node
+        // pointers, reserved in HandleTranslationUnit from the size of the ASTContext)
+        llvm::DenseMap<clang::Decl *, SgNode *> p_decl_translation_map;
+        llvm::DenseMap<clang::Stmt *, SgNode *> p_stmt_translation_map;
+        llvm::DenseMap<const clang::Type *, SgNode *> p_type_translation_map;
         SgGlobal * p_global_scope;
 
         std::map<SgClassType *, bool> p_class_type_decl_first_see_in_type;
         std::map<SgEnumType *, bool>  p_enum_type_decl_first_see_in_type;
 
         // Template declaration cache - maps template name to SgTemplateClassDeclaration
-        // Key: mangled template name (e.g., "std::array")
+        // Key: canonical template name (TemplateName::getAsVoidPointer, the canonical TemplateDecl for "std::array")
         // Value: Template class declaration
-        std::map<std::string, SgTemplateClassDeclaration*> p_template_decl_cache;
+        llvm::DenseMap<const void *, SgTemplateClassDeclaration*> p_template_decl_cache;
 
         // Template instantiation cache - maps instantiation signature to SgTemplateInstantiationDecl
-        // Key: mangled instantiation name (e.g., "std::array<double, 1024>")
+        // Key: template declaration and canonical type of the specialization (e.g., "std::array<double, 1024>"), the
+        // type as written for a dependent specialization
         // Value: Template instantiation declaration
-        std::map<std::string, SgTemplateInstantiationDecl*> p_template_inst_cache;
+        llvm::DenseMap<std::pair<SgTemplateClassDeclaration *, const clang::Type *>, SgTemplateInstantiationDecl*> p_template_inst_cache;
+
+        // Per visitor statistics (-rose:verbose > 0), keyed by the category ("Decl", "Stmt" or "Type") and the kind of
+        // node: Traverse calls translating a node of the kind, Traverse calls finding it in the translation maps, and
+        // time spent in the visitor (without the nodes it traverses)
+        typedef std::pair<const char *, const char *> VisitKind;
+
+        struct VisitStatistics {
+            unsigned long visits;
+            unsigned long hits;
+            double seconds;
+        };
+
+        class VisitTimer {
+            public:
+                VisitTimer(ClangToSageTranslator & translator_, const char * category, const char * kind_);
+                ~VisitTimer();
+
+            private:
+                ClangToSageTranslator & translator;
+                VisitKind kind;
+                std::chrono::steady_clock::time_point start;
+        };
+
+        bool p_visit_timing;
+        llvm::DenseMap<VisitKind, VisitStatistics> p_visit_statistics;
+        std::vector<double> p_visit_children_seconds;
+
+        void countVisitHit(const char * category, const char * kind);
+        void reportVisitStatistics(double seconds);
 
         clang::CompilerInstance  * p_compiler_instance;
-        SagePreprocessorRecord   * p_sage_preprocessor_recorder;
         SgSourceFile             * p_sage_source_file; // Parent file for connecting global scope
 
         Language language;
@@ -204,7 +238,6 @@ class ClangToSageTranslator : public clang::ASTConsumer {
         // Template helper methods
         // Helper: Get or create template class declaration
         SgTemplateClassDeclaration* getOrCreateTemplateDeclaration(
-            const std::string& template_name,
             const clang::TemplateSpecializationType* clang_type);
 
         // Helper: Get or create template instantiation
@@ -616,10 +649,6 @@ class ClangToSageTranslator : public clang::ASTConsumer {
                 virtual bool VisitExtVectorType(clang::ExtVectorType * ext_vector_type, SgNode ** node);
                 virtual bool VisitUsingType(clang::UsingType * using_type, SgNode ** node);
 
-  // Preprocessing access
-        std::pair<Sg_File_Info *, PreprocessingInfo *> preprocessor_top();
-        bool preprocessor_pop();
-
         SgAsmOp::asm_operand_modifier_enum get_sgAsmOperandModifier(std::string modifier);
         SgAsmOp::asm_operand_constraint_enum get_sgAsmOperandConstraint(std::string constraint);
         SgInitializedName::asm_register_name_enum get_sgAsmRegister(std::string reg);
@@ -631,57 +660,64 @@ class ClangToSageTranslator : public clang::ASTConsumer {
 
 void finishSageAST(ClangToSageTranslator & translator);
 
-class SagePreprocessorRecord : public clang::PPCallbacks {
+/* Comments, CPP directives and pragmas of the main file recorded while Clang preprocesses it (see
+ * -rose:frontend:clang_preprocessing_info), so that attachPreprocessingInfo() does not have to lex the file again.
+ *
+ * The record only keeps offsets into the main file while parsing (which may run on a worker thread), the ROSEAttributesList
+ * is built by buildListOfAttributes() once the file is translated. Conditional blocks skipped by the preprocessor are
+ * scanned for their directives and comments, as are the directives that have no callback (e.g. #warning) there. The text
+ * between the recorded elements is tokenized as the lexer (preproc-c.ll) does, so that the token stream is the same.
+ */
+
+class SagePreprocessorRecord : public clang::PPCallbacks, public clang::CommentHandler {
   public:
+    struct Element {
+        unsigned begin;      // offsets in the main file
+        unsigned end;
+        int kind;            // PreprocessingInfo::DirectiveType of a directive or comment, ROSE token id of a token
+        bool is_token;
+    };
 
   protected:
     clang::SourceManager * p_source_manager;
 
-    std::vector<std::pair<Sg_File_Info *, PreprocessingInfo *> > p_preprocessor_record_list;
+    std::vector<Element> p_elements;
+
+    bool inMainFile(clang::SourceLocation loc, unsigned & offset);
+
+    void recordDirective(unsigned offset, int kind);
+    void recordDirective(clang::SourceLocation loc, int kind);
+    void recordPragma(unsigned offset);
+    void recordToken(unsigned begin, unsigned end, int id);
+    void scanSkippedRange(unsigned begin, unsigned end);
 
   public:
     SagePreprocessorRecord(clang::SourceManager * source_manager);
 
     void InclusionDirective(clang::SourceLocation HashLoc, const clang::Token & IncludeTok, llvm::StringRef FileName, bool IsAngled,
-                            const clang::FileEntry * File, clang::SourceLocation EndLoc, llvm::StringRef SearchPath, llvm::StringRef RelativePath);
-    void EndOfMainFile();
-    void Ident(clang::SourceLocation Loc, const std::string & str);
-    void PragmaComment(clang::SourceLocation Loc, const clang::IdentifierInfo * Kind, const std::string & Str);
-    void PragmaMessage(clang::SourceLocation Loc, llvm::StringRef Str);
-    void PragmaDiagnosticPush(clang::SourceLocation Loc, llvm::StringRef Namespace);
-    void PragmaDiagnosticPop(clang::SourceLocation Loc, llvm::StringRef Namespace);
-    void PragmaDiagnostic(clang::SourceLocation Loc, llvm::StringRef Namespace, clang::diag::Severity Severity, llvm::StringRef Str);
-    void MacroExpands(const clang::Token & MacroNameTok, const clang::MacroInfo * MI, clang::SourceRange Range);
-    void MacroDefined(const clang::Token & MacroNameTok, const clang::MacroInfo * MI);
-    void MacroUndefined(const clang::Token & MacroNameTok, const clang::MacroInfo * MI);
-    void Defined(const clang::Token & MacroNameTok);
-    void SourceRangeSkipped(clang::SourceRange Range);
-    void If(clang::SourceRange Range);
-    void Elif(clang::SourceRange Range);
-    void Ifdef(const clang::Token & MacroNameTok);
-    void Ifndef(const clang::Token & MacroNameTok);
-    void Else();
-    void Endif();
-
-    std::pair<Sg_File_Info *, PreprocessingInfo *> top();
-    bool pop(); 
-};
-
-struct NextPreprocessorToInsert {
-    Sg_File_Info * cursor;
-    SgLocatedNode * candidat;
-    PreprocessingInfo * next_to_insert;
-    ClangToSageTranslator & translator;
-
-    NextPreprocessorToInsert(ClangToSageTranslator &);
-
-    NextPreprocessorToInsert * next();
-    
-};
-
-class PreprocessorInserter : public AstTopDownProcessing<NextPreprocessorToInsert *> {
-  public:
-    NextPreprocessorToInsert * evaluateInheritedAttribute(SgNode * astNode, NextPreprocessorToInsert * inheritedValue);
+                            clang::CharSourceRange FilenameRange, clang::OptionalFileEntryRef File, llvm::StringRef SearchPath,
+                            llvm::StringRef RelativePath, const clang::Module * SuggestedModule, bool ModuleImported,
+                            clang::SrcMgr::CharacteristicKind FileType) override;
+    void FileChanged(clang::SourceLocation Loc, FileChangeReason Reason, clang::SrcMgr::CharacteristicKind FileType, clang::FileID PrevFID) override;
+    void PragmaDirective(clang::SourceLocation Loc, clang::PragmaIntroducerKind Introducer) override;
+    void MacroDefined(const clang::Token & MacroNameTok, const clang::MacroDirective * MD) override;
+    void MacroUndefined(const clang::Token & MacroNameTok, const clang::MacroDefinition & MD, const clang::MacroDirective * Undef) override;
+    void SourceRangeSkipped(clang::SourceRange Range, clang::SourceLocation EndifLoc) override;
+    void If(clang::SourceLocation Loc, clang::SourceRange ConditionRange, ConditionValueKind ConditionValue) override;
+    void Elif(clang::SourceLocation Loc, clang::SourceRange ConditionRange, ConditionValueKind ConditionValue, clang::SourceLocation IfLoc) override;
+    void Ifdef(clang::SourceLocation Loc, const clang::Token & MacroNameTok, const clang::MacroDefinition & MD) override;
+    void Elifdef(clang::SourceLocation Loc, const clang::Token & MacroNameTok, const clang::MacroDefinition & MD) override;
+    void Elifdef(clang::SourceLocation Loc, clang::SourceRange ConditionRange, clang::SourceLocation IfLoc) override;
+    void Ifndef(clang::SourceLocation Loc, const clang::Token & MacroNameTok, const clang::MacroDefinition & MD) override;
+    void Elifndef(clang::SourceLocation Loc, const clang::Token & MacroNameTok, const clang::MacroDefinition & MD) override;
+    void Elifndef(clang::SourceLocation Loc, clang::SourceRange ConditionRange, clang::SourceLocation IfLoc) override;
+    void Else(clang::SourceLocation Loc, clang::SourceLocation IfLoc) override;
+    void Endif(clang::SourceLocation Loc, clang::SourceLocation IfLoc) override;
+
+    bool HandleComment(clang::Preprocessor & PP, clang::SourceRange Comment) override;
+
+    // Build the comments, CPP directives and token stream of the main file (main thread only).
+    ROSEAttributesList * buildListOfAttributes(const std::string & filename);
 };
 
 #endif /* _CLANG_FRONTEND_PRIVATE_HPP_ */
@@ -14,9 +14,13 @@ SgNode * ClangToSageTranslator::Traverse(clang::Stmt * stmt) {
     if (stmt == NULL)
         return NULL;
 
-    std::map<clang::Stmt *, SgNode *>::iterator it = p_stmt_translation_map.find(stmt);
-    if (it != p_stmt_translation_map.end())
+    auto it = p_stmt_translation_map.find(stmt);
+    if (it != p_stmt_translation_map.end()) {
+        if (p_visit_timing) countVisitHit("Stmt", stmt->getStmtClassName());
         return it->second; 
+    }
+
+    VisitTimer timer(*this, "Stmt", stmt->getStmtClassName());
 
     SgNode * result = NULL;
     bool ret_status = false;
@@ -98,7 +98,7 @@ SgNode * ClangToSageTranslator::Traverse(const clang::Type * type) {
     if (type == NULL)
         return NULL;
 
-    std::map<const clang::Type *, SgNode *>::iterator it = p_type_translation_map.find(type);
+    auto it = p_type_translation_map.find(type);
 #if DEBUG_TRAVERSE_TYPE
     std::cerr << "Traverse Type : " << type << " " << type->getTypeClassName ()<< std::endl;
 #endif
@@ -106,9 +106,12 @@ SgNode * ClangToSageTranslator::Traverse(const clang::Type * type) {
 #if DEBUG_TRAVERSE_TYPE
       std::cerr << " already visited : node = " << it->second << std::endl;
 #endif
+      if (p_visit_timing) countVisitHit("Type", type->getTypeClassName());
       return it->second;
     }
 
+    VisitTimer timer(*this, "Type", type->getTypeClassName());
+
     SgNode * result = NULL;
     bool ret_status = false;
 
@@ -1076,16 +1079,19 @@ ClangToSageTranslator::buildTemplateParameters(
 // Get or create template class declaration
 SgTemplateClassDeclaration*
 ClangToSageTranslator::getOrCreateTemplateDeclaration(
-    const std::string& template_name,
     const clang::TemplateSpecializationType* clang_type) {
 
-    // Check cache first
-    auto it = p_template_decl_cache.find(template_name);
+    // Check cache first (keyed by the canonical template name, the name is only built for a new template)
+    clang::ASTContext & ast_context = p_compiler_instance->getASTContext();
+    const void * template_key = ast_context.getCanonicalTemplateName(clang_type->getTemplateName()).getAsVoidPointer();
+    auto it = p_template_decl_cache.find(template_key);
     if (it != p_template_decl_cache.end()) {
-        // DEBUG: // std::cerr << "DEBUG: CACHE HIT for template_name = '" << template_name << "'" << std::endl;
+        // DEBUG: // std::cerr << "DEBUG: CACHE HIT for template_key = " << template_key << std::endl;
         return it->second;
     }
-    // DEBUG: // std::cerr << "DEBUG: CACHE MISS for template_name = '" << template_name << "' - creating new" << std::endl;
+    // DEBUG: // std::cerr << "DEBUG: CACHE MISS for template_key = " << template_key << " - creating new" << std::endl;
+
+    std::string template_name = mangleTemplateName(clang_type->getTemplateName());
 
     // Extract namespace prefix and base name (e.g., "std" and "array" from "std::array")
     std::string namespace_prefix;
@@ -1141,7 +1147,7 @@ ClangToSageTranslator::getOrCreateTemplateDeclaration(
             std::string qualified_name = namespace_prefix + "::" + base_name;
 
             // Add to global qualified name map
-            std::map<SgNode*,std::string>& typeMap = SgNode::get_globalQualifiedNameMapForTypes();
+            SgNameQualificationMap& typeMap = SgNode::get_globalQualifiedNameMapForTypes();
             typeMap[class_type] = qualified_name;
 
             // DEBUG: // std::cerr << "DEBUG: Set qualified name '" << qualified_name << "' for type" << std::endl;
@@ -1153,7 +1159,7 @@ ClangToSageTranslator::getOrCreateTemplateDeclaration(
     // synthetic representation of standard library templates.
 
     // Cache it
-    p_template_decl_cache[template_name] = template_decl;
+    p_template_decl_cache[template_key] = template_decl;
 
     return template_decl;
 }
@@ -1263,6 +1269,17 @@ ClangToSageTranslator::getOrCreateTemplateInstantiation(
     SgTemplateClassDeclaration* template_decl,
     const clang::TemplateSpecializationType* clang_type) {
 
+    // Check cache (the same template and canonical type, however the template arguments are spelled). A dependent
+    // specialization is keyed by its own type: array<T, 4> and array<U, 4> of two templates have the same canonical
+    // type but are unparsed with the names of their template parameters.
+    const clang::Type * inst_type = clang_type->isInstantiationDependentType() ? clang_type
+                                                                               : clang_type->getCanonicalTypeInternal().getTypePtr();
+    std::pair<SgTemplateClassDeclaration *, const clang::Type *> inst_key(template_decl, inst_type);
+    auto it = p_template_inst_cache.find(inst_key);
+    if (it != p_template_inst_cache.end()) {
+        return it->second;
+    }
+
     // Extract both base name and qualified name for the template
     std::string template_base_name = template_decl->get_name().getString();
 
@@ -1271,24 +1288,18 @@ ClangToSageTranslator::getOrCreateTemplateInstantiation(
     std::string template_qualified_name = template_base_name;
     SgClassType* template_type = template_decl->get_type();
     if (template_type != nullptr) {
-        std::map<SgNode*,std::string>& typeMap = SgNode::get_globalQualifiedNameMapForTypes();
-        auto it = typeMap.find(template_type);
-        if (it != typeMap.end()) {
-            template_qualified_name = it->second;  // Use "std::array" instead of "array"
+        SgNameQualificationMap& typeMap = SgNode::get_globalQualifiedNameMapForTypes();
+        auto name_it = typeMap.find(template_type);
+        if (name_it != typeMap.end()) {
+            template_qualified_name = name_it->second;  // Use "std::array" instead of "array"
         }
     }
 
-    // Use qualified name in cache key to avoid namespace collisions
-    // Example: "std::array<int>" and "my_ns::array<int>" must have different cache keys
+    // Use qualified name in the symbol name to avoid namespace collisions
+    // Example: "std::array<int>" and "my_ns::array<int>" must have different symbol names
     // Otherwise they would both mangle to "array_int" and collide
     std::string inst_name_full = mangleTemplateInstantiation(template_qualified_name, clang_type);
 
-    // Check cache
-    auto it = p_template_inst_cache.find(inst_name_full);
-    if (it != p_template_inst_cache.end()) {
-        return it->second;
-    }
-
     // Build template arguments
     SgTemplateArgumentPtrList args = buildTemplateArguments(clang_type);
 
@@ -1401,8 +1412,8 @@ ClangToSageTranslator::getOrCreateTemplateInstantiation(
     SgClassSymbol* class_symbol = new SgClassSymbol(inst_decl);
     inst_scope->insert_symbol(SgName(inst_name_full), class_symbol);
 
-    // Cache it with full name
-    p_template_inst_cache[inst_name_full] = inst_decl;
+    // Cache it
+    p_template_inst_cache[inst_key] = inst_decl;
 
     // TODO: Registration in decl_translation_map is required so that VisitClassTemplateSpecializationDecl
     // can find this instantiation when it encounters the declaration later.
@@ -1424,15 +1435,9 @@ bool ClangToSageTranslator::VisitTemplateSpecializationType(clang::TemplateSpeci
     // We want to create proper SgTemplateInstantiationDecl nodes with template arguments
     // Desugaring would lose the template argument information
 
-    // Extract template name
-    clang::TemplateName tname = template_specialization_type->getTemplateName();
-    std::string template_name = mangleTemplateName(tname);
-
-    // DEBUG: // std::cerr << "DEBUG VisitTemplateSpecializationType: template_name = '" << template_name << "'" << std::endl;
-
     // Get or create template class declaration
     SgTemplateClassDeclaration* template_decl =
-        getOrCreateTemplateDeclaration(template_name, template_specialization_type);
+        getOrCreateTemplateDeclaration(template_specialization_type);
 
     // Get or create template instantiation
     SgTemplateInstantiationDecl* inst_decl =
@@ -1,18 +1,140 @@
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 #include "sage3basic.h"
 #include "clang-frontend-private.hpp"
+#include "cmdline.h"
+#include "FileSystem.h"
 
 #include "rose_config.h"
 
 #include "clang-to-dot.hpp"
 
+#include "clang/Frontend/FrontendActions.h"
+
 extern bool roseInstallPrefix(std::string&);
+extern void setPreprocessorDirectivesFromFrontend(SgSourceFile* sourceFile, ROSEAttributesList* listOfAttributes);
 
 // DQ (11/28/2020): Use this for testing the DOT graph generator.
 #define EXIT_AFTER_BUILDING_DOT_FILE 0
 
+/* Result of running Clang over one input file, before its translation to Sage III */
+
+struct ClangParsedUnit {
+    clang::CompilerInstance * compiler_instance;
+    ClangToSageTranslator::Language language;
+    std::string input_file;
+    unsigned numErrors;
+
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> vfs;
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> diagnostic_options;
+
+    std::string diagnostics;
+    std::unique_ptr<llvm::raw_string_ostream> diagnostics_stream;
+
+    // Owned by the preprocessor (-rose:frontend:clang_preprocessing_info)
+    SagePreprocessorRecord * preprocessor_record;
+
+    ClangParsedUnit() : compiler_instance(NULL), language(ClangToSageTranslator::unknown), numErrors(0), preprocessor_record(NULL) {}
+
+    // The CompilerInstance owns the diagnostic printer that writes to diagnostics_stream.
+    ~ClangParsedUnit() { delete compiler_instance; }
+};
+
+/* Files parsed ahead of their translation by clang_preparse() */
+
+namespace ClangPreparse {
+    struct Job {
+        SgSourceFile * file;
+        std::vector<std::string> command_line;
+        std::promise<ClangParsedUnit *> result;
+    };
+
+    std::vector<std::unique_ptr<Job> > jobs;
+    std::map<SgSourceFile *, std::future<ClangParsedUnit *> > pending;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next_job(0);
+}
+
+static ClangParsedUnit * clang_parse(int argc, char ** argv, bool buffer_diagnostics);
+
+static void clang_preparse_worker() {
+    for (size_t i = ClangPreparse::next_job++; i < ClangPreparse::jobs.size(); i = ClangPreparse::next_job++) {
+        ClangPreparse::Job & job = *ClangPreparse::jobs[i];
+        try {
+            int argc = 0;
+            char ** argv = NULL;
+            CommandlineProcessing::generateArgcArgvFromList(job.command_line, argc, argv);
+            job.result.set_value(clang_parse(argc, argv, true));
+        } catch (...) {
+            job.result.set_exception(std::current_exception());
+        }
+    }
+}
+
+void clang_preparse(const std::vector<std::pair<SgSourceFile *, std::vector<std::string> > > & files, int jobs) {
+    ROSE_ASSERT(ClangPreparse::workers.empty() && ClangPreparse::pending.empty());
+
+    ClangPreparse::jobs.clear();
+    ClangPreparse::next_job = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        ClangPreparse::Job * job = new ClangPreparse::Job();
+        job->file = files[i].first;
+        job->command_line = files[i].second;
+        ClangPreparse::pending[job->file] = job->result.get_future();
+        ClangPreparse::jobs.push_back(std::unique_ptr<ClangPreparse::Job>(job));
+    }
+
+    size_t num_workers = std::min<size_t>(jobs > 0 ? jobs : 1, files.size());
+    for (size_t i = 0; i < num_workers; i++) {
+        ClangPreparse::workers.push_back(std::thread(clang_preparse_worker));
+    }
+}
+
+void clang_preparse_finish() {
+    for (size_t i = 0; i < ClangPreparse::workers.size(); i++) {
+        ClangPreparse::workers[i].join();
+    }
+    ClangPreparse::workers.clear();
+
+ // Files that were never translated (e.g. the frontend gave up on an earlier file) still own a CompilerInstance.
+    std::map<SgSourceFile *, std::future<ClangParsedUnit *> >::iterator it;
+    for (it = ClangPreparse::pending.begin(); it != ClangPreparse::pending.end(); it++) {
+        try {
+            delete it->second.get();
+        } catch (...) {}
+    }
+    ClangPreparse::pending.clear();
+    ClangPreparse::jobs.clear();
+}
+
+/* Claim the unit parsed ahead for sageFile, waiting for its worker if needed; NULL if it was not parsed ahead */
+
+static ClangParsedUnit * clang_claim_preparsed(SgSourceFile & sageFile) {
+    std::map<SgSourceFile *, std::future<ClangParsedUnit *> >::iterator it = ClangPreparse::pending.find(&sageFile);
+    if (it == ClangPreparse::pending.end()) return NULL;
+
+    std::future<ClangParsedUnit *> result = std::move(it->second);
+    ClangPreparse::pending.erase(it);
+
+    ClangParsedUnit * unit = result.get();
+    if (!unit->diagnostics.empty()) {
+        unit->diagnostics_stream->flush();
+        llvm::errs() << unit->diagnostics;
+        unit->diagnostics.clear();
+    }
+    return unit;
+}
+
 int clang_main(int argc, char ** argv, SgSourceFile& sageFile) {
 
  // printf ("sageFile.get_clang_il_to_graphviz() = %s \n",sageFile.get_clang_il_to_graphviz() ? "true" : "false");
@@ -49,6 +171,459 @@ int clang_main(int argc, char ** argv, SgSourceFile& sageFile) {
 #endif
        }
 
+    ClangParsedUnit * unit = clang_claim_preparsed(sageFile);
+    if (unit == NULL) {
+        unit = clang_parse(argc, argv, false);
+    }
+
+    unsigned numErrors = unit->numErrors;
+    if (numErrors > 0) {
+        printf ("Clang found %d diagnostic errors during parsing\n", numErrors);
+    }
+
+  // 3 - Translate
+
+    clang::CompilerInstance * compiler_instance = unit->compiler_instance;
+    std::string input_file = unit->input_file;
+
+    ClangToSageTranslator * translator = new ClangToSageTranslator(compiler_instance, unit->language, &sageFile);
+    translator->HandleTranslationUnit(compiler_instance->getASTContext());
+
+    SgGlobal * global_scope = translator->getGlobalScope();
+
+  // 4 - Attach to the file
+
+    if (sageFile.get_globalScope() != NULL) SageInterface::deleteAST(sageFile.get_globalScope());
+
+    sageFile.set_globalScope(global_scope);
+
+    // Parent relationship already set up during global scope creation
+
+    std::string file_name(input_file);
+
+    Sg_File_Info * start_fi = new Sg_File_Info(file_name, 0, 0);
+    Sg_File_Info * end_fi   = new Sg_File_Info(file_name, 0, 0);
+
+    global_scope->set_startOfConstruct(start_fi);
+
+    global_scope->set_endOfConstruct(end_fi);
+
+  // 6 - Initialize token subsequence map for unparsing
+  // The backend unparser expects this map to exist (even if empty) for token-based unparsing
+  // Note: Raw pointer allocation follows ROSE's standard memory management pattern (see tokenStreamMapping.C).
+  // Memory is managed by the global Rose::tokenSubsequenceMapOfMapsBySourceFile map and persists
+  // for the program lifetime, consistent with ROSE's architecture for AST-related data structures.
+  //
+  // Check if a token map already exists (e.g., from a previous parse after deleteAST).
+  // If it exists, clear it for reuse. Otherwise, create a new one.
+    if (Rose::tokenSubsequenceMapOfMapsBySourceFile.find(&sageFile) != Rose::tokenSubsequenceMapOfMapsBySourceFile.end()) {
+        // Map already exists (re-parsing after deleteAST) - clear it for reuse
+        std::map<SgNode*,TokenStreamSequenceToNodeMapping*>* existingMap = Rose::tokenSubsequenceMapOfMapsBySourceFile[&sageFile];
+        if (existingMap != nullptr) {
+            existingMap->clear();
+        }
+    } else {
+        // First time parsing this file - create new map
+        std::map<SgNode*,TokenStreamSequenceToNodeMapping*>* tokenMap = new std::map<SgNode*,TokenStreamSequenceToNodeMapping*>();
+        sageFile.set_tokenSubsequenceMap(tokenMap);
+    }
+
+  // 7 - Finish the AST (fixup phase)
+
+    finishSageAST(*translator);
+
+  // 7b - Hand the comments, directives and tokens recorded by the preprocessor to attachPreprocessingInfo()
+
+    if (unit->preprocessor_record != NULL && sageFile.get_skip_commentsAndDirectives() == false) {
+        ROSEAttributesList * attributes = unit->preprocessor_record->buildListOfAttributes(sageFile.get_sourceFileNameWithPath());
+        setPreprocessorDirectivesFromFrontend(&sageFile, attributes);
+    }
+
+  // 8 - Cleanup LLVM objects
+  //
+  // Now that we use createPhysicalFileSystem() instead of getRealFileSystem(),
+  // the CompilerInstance owns its own VFS instance rather than sharing the global singleton.
+  // This means we can safely delete the CompilerInstance without causing double-free errors.
+  //
+  // The translator refers to the CompilerInstance's SourceManager, so it is destroyed first. The
+  // ROSE AST (global_scope, etc.) persists in sageFile and is NOT owned by the translator, so it
+  // remains valid after cleanup.
+
+    delete translator;
+    delete unit;
+
+    // REX: Experimental C++ frontend is permissive - if we successfully built an AST
+    // (valid global_scope), allow backend to run even if Clang reported errors.
+    // This is necessary because Clang may report missing headers or other compilation
+    // errors, but we still want to attempt code generation with the partial AST.
+    if (global_scope != NULL) {
+        if (numErrors > 0) {
+            printf ("Note: Proceeding to backend despite %d Clang diagnostic error(s) because AST was successfully constructed\n", numErrors);
+        }
+        return 0;  // Success - AST was built
+    } else {
+        printf ("Error: Failed to build AST - global_scope is NULL\n");
+        return (numErrors > 0) ? numErrors : 1;  // Failure - no AST
+    }
+}
+
+/* Options of a compiler instance for the language and the arguments built by clang_parse(). The parse of a file and the
+ * build of the precompiled header of its #include lines (see clang_precompiled_prefix()) must agree on them. */
+
+static clang::Language clang_configure(clang::CompilerInstance * compiler_instance, ClangToSageTranslator::Language language,
+                                       llvm::ArrayRef<const char *> args, bool enable_openmp, bool enable_openmp_simd) {
+    clang::CompilerInvocation &invocation = compiler_instance->getInvocation();
+    const llvm::Triple target_triple(llvm::sys::getDefaultTargetTriple());
+
+    // Parse command-line arguments to populate invocation (including FileSystemOptions like -working-directory, -sysroot)
+    clang::CompilerInvocation::CreateFromArgs(invocation, args, compiler_instance->getDiagnostics());
+
+    clang::LangOptions & lang_opts = compiler_instance->getLangOpts();
+    std::vector<std::string> lang_specific_includes;
+    clang::LangStandard::Kind requested_std = lang_opts.LangStd;
+    clang::LangStandard std_info = clang::LangStandard::getLangStandardForKind(requested_std);
+    clang::Language clang_lang = clang::Language::C;
+    bool enable_cuda = false;
+    bool enable_opencl = false;
+
+    switch (language) {
+        case ClangToSageTranslator::C:
+            if (!(std_info.isC99() || std_info.isC11() || std_info.isC17() || std_info.isC23())) {
+                requested_std = clang::LangStandard::lang_gnu17;
+            }
+            clang_lang = clang::Language::C;
+            break;
+        case ClangToSageTranslator::CPLUSPLUS:
+            if (!std_info.isCPlusPlus()) {
+                requested_std = clang::LangStandard::lang_gnucxx17;
+            }
+            clang_lang = clang::Language::CXX;
+            break;
+        case ClangToSageTranslator::CUDA:
+            if (!std_info.isCPlusPlus()) {
+                requested_std = clang::LangStandard::lang_gnucxx17;
+            }
+            clang_lang = clang::Language::CUDA;
+            enable_cuda = true;
+            break;
+        case ClangToSageTranslator::OPENCL:
+            if (!std_info.isOpenCL()) {
+                requested_std = clang::LangStandard::lang_opencl30;
+            }
+            clang_lang = clang::Language::OpenCL;
+            enable_opencl = true;
+            break;
+        case ClangToSageTranslator::OBJC:
+            ROSE_ASSERT(!"Objective-C is not supported by ROSE Compiler.");
+        default:
+            ROSE_ABORT();
+    }
+
+    clang::LangOptions::setLangDefaults(
+        lang_opts, clang_lang, target_triple, lang_specific_includes, requested_std);
+
+    if (language == ClangToSageTranslator::CPLUSPLUS) {
+        ROSE_ASSERT(lang_opts.CPlusPlus && "Expected C++ mode after setting language defaults");
+    }
+
+    if (enable_cuda) {
+        lang_opts.CUDA = 1;
+    }
+    if (enable_opencl) {
+        lang_opts.OpenCL = 1;
+    }
+    if (enable_openmp) {
+        lang_opts.OpenMP = 1;
+        lang_opts.OpenMPUseTLS = 1;
+    }
+    if (enable_openmp_simd) {
+        lang_opts.OpenMPSimd = 1;
+    }
+
+    // Now create file manager with FileSystemOptions from the parsed invocation
+    compiler_instance->createFileManager();
+
+    clang::PreprocessorOptions &pp_opts = compiler_instance->getInvocation().getPreprocessorOpts();
+    if (!lang_specific_includes.empty()) {
+        pp_opts.Includes.insert(pp_opts.Includes.end(),
+                                lang_specific_includes.begin(),
+                                lang_specific_includes.end());
+    }
+
+    // LLVM 20 requires shared_ptr, LLVM 21+ requires reference
+#if LLVM_VERSION_MAJOR >= 21
+    clang::TargetOptions target_options;
+    target_options.Triple = llvm::sys::getDefaultTargetTriple();
+    clang::TargetInfo * target_info = clang::TargetInfo::CreateTargetInfo(compiler_instance->getDiagnostics(), target_options);
+#else
+    auto target_options = std::make_shared<clang::TargetOptions>();
+    target_options->Triple = llvm::sys::getDefaultTargetTriple();
+    clang::TargetInfo * target_info = clang::TargetInfo::CreateTargetInfo(compiler_instance->getDiagnostics(), target_options);
+#endif
+    compiler_instance->setTarget(target_info);
+
+    return clang_lang;
+}
+
+/* Precompiled headers of the #include lines at the start of the input files (-rose:frontend:clang_precompiled_headers)
+ *
+ * The #include lines that come before any other code or directive of a file (its prefix) are written to a header of
+ * their own, which is precompiled with the options of the file; the file is then parsed with the precompiled header,
+ * and the include guards of the headers skip its own #include lines of the prefix. The prefix stops before the first
+ * header without an include guard (or #pragma once). The header, the precompiled header and the list of the files it
+ * was built from, with the hash of their contents, are kept in the directory and keyed by the hash of the prefix and of
+ * the options: files and runs with the same prefix share the precompiled header, which is built again once one of the
+ * files it was built from changes.
+ */
+
+namespace ClangPrecompiledPrefix {
+    // Builds and validations are serialized (the files may be parsed ahead on worker threads).
+    std::mutex mutex;
+
+    // Key of the prefix of a file -> precompiled header validated or built by the process, empty if it cannot be built.
+    std::map<uint64_t, std::string> precompiled;
+
+    const char * const dependencies_header = "ROSE precompiled header 1";
+}
+
+/* The #include lines at the start of the file. A file included with quotes from the directory of the input file is
+ * named by its absolute path, so that it is found from the header in the directory of the precompiled headers. */
+
+static std::vector<std::string> clang_include_prefix(const std::string & input_file, const std::string & text) {
+    std::vector<std::string> includes;
+
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::absolute(input_file, error).parent_path();
+
+    size_t i = 0;
+    while (i < text.size()) {
+        if (isspace((unsigned char) text[i])) {
+            i++;
+            continue;
+        }
+        if (text.compare(i, 2, "//") == 0) {
+            i = text.find('\n', i);
+            if (i == std::string::npos) break;
+            continue;
+        }
+        if (text.compare(i, 2, "/*") == 0) {
+            i = text.find("*/", i + 2);
+            if (i == std::string::npos) break;
+            i += 2;
+            continue;
+        }
+        if (text[i] != '#') break;
+
+        size_t end = text.find('\n', i);
+        std::string line = text.substr(i, end == std::string::npos ? std::string::npos : end - i);
+
+        size_t j = line.find_first_not_of(" \t", 1);
+        if (j == std::string::npos || line.compare(j, 7, "include") != 0) break;
+        j = line.find_first_not_of(" \t", j + 7);
+        if (j == std::string::npos || (line[j] != '<' && line[j] != '"')) break;   // #include_next, #include MACRO
+
+        char open = line[j];
+        char close = (open == '<') ? '>' : '"';
+        size_t k = line.find(close, j + 1);
+        if (k == std::string::npos) break;
+
+        // Only a // comment may follow (a /* comment may go on over the next lines)
+        size_t rest = line.find_first_not_of(" \t\r", k + 1);
+        if (rest != std::string::npos && line.compare(rest, 2, "//") != 0) break;
+
+        std::string name = line.substr(j + 1, k - j - 1);
+        if (open == '"' && !directory.empty()) {
+            std::filesystem::path path = directory / name;
+            if (std::filesystem::is_regular_file(path, error)) {
+                name = path.lexically_normal().string();
+            }
+        }
+        includes.push_back(std::string("#include ") + open + name + close);
+
+        if (end == std::string::npos) break;
+        i = end + 1;
+    }
+
+    return includes;
+}
+
+/* The precompiled header is up to date if the files it was built from have the contents they had then */
+
+static bool clang_precompiled_prefix_is_valid(const std::string & pch_file, const std::string & dependencies_file) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(pch_file, error)) return false;
+
+    std::ifstream stream(dependencies_file.c_str());
+    std::string line;
+    if (!std::getline(stream, line) || line != ClangPrecompiledPrefix::dependencies_header) return false;
+
+    while (std::getline(stream, line)) {
+        size_t space = line.find(' ');
+        if (space == std::string::npos) return false;
+
+        std::string contents;
+        if (!Rose::FileSystem::readContents(line.substr(space + 1), contents)) return false;
+
+        uint64_t hash = Rose::FileSystem::hashContents(contents);
+        if (strtoull(line.substr(0, space).c_str(), NULL, 16) != hash) return false;
+    }
+
+    return true;
+}
+
+/* Records the files included by the main file (the header of the prefix) */
+
+class ClangPrefixInclusions : public clang::PPCallbacks {
+  public:
+    ClangPrefixInclusions(clang::SourceManager & source_manager, std::vector<clang::OptionalFileEntryRef> & files) :
+        p_source_manager(source_manager), p_files(files) {}
+
+    void InclusionDirective(clang::SourceLocation HashLoc, const clang::Token & IncludeTok, llvm::StringRef FileName, bool IsAngled,
+                            clang::CharSourceRange FilenameRange, clang::OptionalFileEntryRef File, llvm::StringRef SearchPath,
+                            llvm::StringRef RelativePath, const clang::Module * SuggestedModule, bool ModuleImported,
+                            clang::SrcMgr::CharacteristicKind FileType) override {
+        if (p_source_manager.isInMainFile(HashLoc)) p_files.push_back(File);
+    }
+
+  protected:
+    clang::SourceManager & p_source_manager;
+    std::vector<clang::OptionalFileEntryRef> & p_files;
+};
+
+/* Precompile the header of the prefix (count #include lines); returns the number of leading headers of the prefix
+ * that have include guards (the precompiled header is only kept if they all have), or -1 if it cannot be built. */
+
+static int clang_build_precompiled_prefix(const std::string & header_file, const std::string & pch_file, const std::string & dependencies_file,
+                                          size_t count, ClangToSageTranslator::Language language, llvm::ArrayRef<const char *> args,
+                                          bool enable_openmp, bool enable_openmp_simd) {
+    clang::CompilerInstance builder;
+
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> vfs = llvm::vfs::createPhysicalFileSystem();
+    builder.createDiagnostics(*vfs, new clang::IgnoringDiagConsumer(), true);
+
+    clang::Language clang_lang = clang_configure(&builder, language, args, enable_openmp, enable_openmp_simd);
+    builder.getFrontendOpts().OutputFile = pch_file;
+    builder.getFrontendOpts().ProgramAction = clang::frontend::GeneratePCH;
+
+    std::vector<clang::OptionalFileEntryRef> included;
+    std::string dependencies = std::string(ClangPrecompiledPrefix::dependencies_header) + "\n";
+    int guarded = -1;
+
+    clang::GeneratePCHAction action;
+    if (action.BeginSourceFile(builder, clang::FrontendInputFile(header_file, clang::InputKind(clang_lang).getHeader()))) {
+        builder.getPreprocessor().addPPCallbacks(std::make_unique<ClangPrefixInclusions>(builder.getSourceManager(), included));
+
+        if (llvm::Error error = action.Execute()) {
+            llvm::consumeError(std::move(error));
+        } else if (!builder.getDiagnostics().hasErrorOccurred() && included.size() == count) {
+            clang::HeaderSearch & header_search = builder.getPreprocessor().getHeaderSearchInfo();
+            guarded = 0;
+            while ((size_t) guarded < count && included[guarded] && header_search.isFileMultipleIncludeGuarded(*included[guarded])) {
+                guarded++;
+            }
+
+            clang::SourceManager & source_manager = builder.getSourceManager();
+            for (clang::SourceManager::fileinfo_iterator it = source_manager.fileinfo_begin(); it != source_manager.fileinfo_end(); it++) {
+                std::string filename = it->first.getName().str();
+                std::string contents;
+                if (!Rose::FileSystem::readContents(filename, contents)) {
+                    guarded = -1;
+                    break;
+                }
+                char hash[32];
+                snprintf(hash, sizeof(hash), "%016llx", (unsigned long long) Rose::FileSystem::hashContents(contents));
+                dependencies += std::string(hash) + " " + filename + "\n";
+            }
+        }
+
+        // Writes the precompiled header (it is removed if there were errors)
+        action.EndSourceFile();
+    }
+
+    std::error_code error;
+    if ((size_t) guarded != count || !Rose::FileSystem::writeContentsAtomically(dependencies_file, dependencies)) {
+        std::filesystem::remove(pch_file, error);
+        return (guarded >= 0 && (size_t) guarded != count) ? guarded : -1;
+    }
+
+    return guarded;
+}
+
+/* The precompiled header of the #include lines at the start of the file, built if needed; empty if there is none */
+
+static std::string clang_precompiled_prefix(const std::string & input_file, ClangToSageTranslator::Language language, llvm::ArrayRef<const char *> args,
+                                            bool enable_openmp, bool enable_openmp_simd) {
+    std::string text;
+    if (!Rose::FileSystem::readContents(input_file, text)) return "";
+
+    std::vector<std::string> includes = clang_include_prefix(input_file, text);
+    if (includes.empty()) return "";
+
+    // The options that affect the precompiled header
+    std::string options = std::string(LLVM_VERSION_STRING) + '\0' + std::to_string((int) language) + '\0' +
+                          (enable_openmp ? "1" : "0") + (enable_openmp_simd ? "1" : "0") + '\0';
+    for (size_t i = 0; i < args.size(); i++) {
+        options += std::string(args[i]) + '\0';
+    }
+    uint64_t options_hash = Rose::FileSystem::hashContents(options);
+
+    std::string prefix;
+    for (size_t i = 0; i < includes.size(); i++) {
+        prefix += includes[i] + "\n";
+    }
+    uint64_t prefix_key = Rose::FileSystem::hashContents(prefix, options_hash);
+
+    std::lock_guard<std::mutex> lock(ClangPrecompiledPrefix::mutex);
+
+    std::map<uint64_t, std::string>::iterator it = ClangPrecompiledPrefix::precompiled.find(prefix_key);
+    if (it != ClangPrecompiledPrefix::precompiled.end()) return it->second;
+
+    std::string directory = Rose::Cmdline::Frontend::clangPrecompiledHeaders;
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // Precompile the longest prefix of headers with include guards
+    std::string result;
+    size_t count = includes.size();
+    while (count > 0) {
+        std::string header;
+        for (size_t i = 0; i < count; i++) {
+            header += includes[i] + "\n";
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx", (unsigned long long) Rose::FileSystem::hashContents(header, options_hash));
+        std::string base = directory + "/" + name;
+        std::string header_file = base + ".h";
+        std::string pch_file = base + ".pch";
+        std::string dependencies_file = base + ".deps";
+
+        if (clang_precompiled_prefix_is_valid(pch_file, dependencies_file)) {
+            result = pch_file;
+            break;
+        }
+
+        if (!Rose::FileSystem::writeContentsAtomically(header_file, header)) break;
+
+        int guarded = clang_build_precompiled_prefix(header_file, pch_file, dependencies_file, count, language, args, enable_openmp, enable_openmp_simd);
+        if (guarded < 0) break;
+        if ((size_t) guarded == count) {
+            result = pch_file;
+            break;
+        }
+        count = guarded;
+    }
+
+    if (SgProject::get_verbose() > 0) {
+        printf ("Clang precompiled header of the %zu #include lines at the start of %s: %s\n",
+                includes.size(), input_file.c_str(), result.empty() ? "none" : result.c_str());
+    }
+
+    ClangPrecompiledPrefix::precompiled[prefix_key] = result;
+    return result;
+}
+
+static ClangParsedUnit * clang_parse(int argc, char ** argv, bool buffer_diagnostics) {
   // 0 - Analyse Cmd Line
 
     std::vector<std::string> sys_dirs_list;
@@ -251,144 +826,86 @@ int clang_main(int argc, char ** argv, SgSourceFile& sageFile) {
 #endif
         i++;
     }
-    for (it_str = inc_list.begin(); it_str != inc_list.end(); it_str++) {
-        args[i] = new char[it_str->size() + 9];
-        args[i][0] = '-'; args[i][1] = 'i'; args[i][2] = 'n'; args[i][3] = 'c';
-        args[i][4] = 'l'; args[i][5] = 'u'; args[i][6] = 'd'; args[i][7] = 'e';
-        strcpy(&(args[i][8]), it_str->c_str());
-#if DEBUG_ARGS
-        std::cerr << "args[" << i << "] = " << args[i] << std::endl;
-#endif
-        i++;
-    }
-    for (it_str = passthrough_args.begin(); it_str != passthrough_args.end(); ++it_str) {
-        args[i] = new char[it_str->size() + 1];
-        strcpy(args[i], it_str->c_str());
-#if DEBUG_ARGS
-        std::cerr << "args[" << i << "] = " << args[i] << std::endl;
-#endif
-        ++i;
-    }
-
-
-  // 2 - Create a compiler instance
-
-    clang::CompilerInstance * compiler_instance = new clang::CompilerInstance();
-
-    // Create diagnostics with instance-specific physical filesystem (avoids global singleton double-free)
-    // Use createPhysicalFileSystem() instead of getRealFileSystem() to avoid sharing the global singleton.
-    // getRealFileSystem() returns a static IntrusiveRefCntPtr that libLLVM.so's global destructor also
-    // tries to clean up, causing double-free. createPhysicalFileSystem() creates a new instance that
-    // CompilerInstance can safely own and destroy.
-    //
-    // Persist the VFS IntrusiveRefCntPtr so it lives beyond createDiagnostics() call.
-    // Otherwise the temporary unique_ptr is destroyed immediately, leaving a dangling reference.
-    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> vfs = llvm::vfs::createPhysicalFileSystem();
-
-    // Use IntrusiveRefCntPtr for DiagnosticOptions to manage lifetime properly.
-    // TextDiagnosticPrinter stores a pointer to DiagOpts, so it must outlive the function scope.
-    // IntrusiveRefCntPtr ensures proper reference counting and cleanup.
-    llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> DiagOpts = llvm::makeIntrusiveRefCnt<clang::DiagnosticOptions>();
-    clang::TextDiagnosticPrinter * diag_printer = new clang::TextDiagnosticPrinter(llvm::errs(), DiagOpts.get());
-
-    // LLVM 20+ API - requires VFS as first parameter
-    compiler_instance->createDiagnostics(*vfs, diag_printer, true);
-
-    clang::CompilerInvocation &invocation = compiler_instance->getInvocation();
-    const llvm::Triple target_triple(llvm::sys::getDefaultTargetTriple());
-
-    // Parse command-line arguments to populate invocation (including FileSystemOptions like -working-directory, -sysroot)
-    llvm::ArrayRef<const char *> argsArrayRef(args, &(args[cnt]));
-    clang::CompilerInvocation::CreateFromArgs(invocation, argsArrayRef, compiler_instance->getDiagnostics());
-
-    clang::LangOptions & lang_opts = compiler_instance->getLangOpts();
-    std::vector<std::string> lang_specific_includes;
-    clang::LangStandard::Kind requested_std = lang_opts.LangStd;
-    clang::LangStandard std_info = clang::LangStandard::getLangStandardForKind(requested_std);
-    clang::Language clang_lang = clang::Language::C;
-    bool enable_cuda = false;
-    bool enable_opencl = false;
-
-    switch (language) {
-        case ClangToSageTranslator::C:
-            if (!(std_info.isC99() || std_info.isC11() || std_info.isC17() || std_info.isC23())) {
-                requested_std = clang::LangStandard::lang_gnu17;
-            }
-            clang_lang = clang::Language::C;
-            break;
-        case ClangToSageTranslator::CPLUSPLUS:
-            if (!std_info.isCPlusPlus()) {
-                requested_std = clang::LangStandard::lang_gnucxx17;
-            }
-            clang_lang = clang::Language::CXX;
-            break;
-        case ClangToSageTranslator::CUDA:
-            if (!std_info.isCPlusPlus()) {
-                requested_std = clang::LangStandard::lang_gnucxx17;
-            }
-            clang_lang = clang::Language::CUDA;
-            enable_cuda = true;
-            break;
-        case ClangToSageTranslator::OPENCL:
-            if (!std_info.isOpenCL()) {
-                requested_std = clang::LangStandard::lang_opencl30;
-            }
-            clang_lang = clang::Language::OpenCL;
-            enable_opencl = true;
-            break;
-        case ClangToSageTranslator::OBJC:
-            ROSE_ASSERT(!"Objective-C is not supported by ROSE Compiler.");
-        default:
-            ROSE_ABORT();
+    for (it_str = inc_list.begin(); it_str != inc_list.end(); it_str++) {
+        args[i] = new char[it_str->size() + 9];
+        args[i][0] = '-'; args[i][1] = 'i'; args[i][2] = 'n'; args[i][3] = 'c';
+        args[i][4] = 'l'; args[i][5] = 'u'; args[i][6] = 'd'; args[i][7] = 'e';
+        strcpy(&(args[i][8]), it_str->c_str());
+#if DEBUG_ARGS
+        std::cerr << "args[" << i << "] = " << args[i] << std::endl;
+#endif
+        i++;
+    }
+    for (it_str = passthrough_args.begin(); it_str != passthrough_args.end(); ++it_str) {
+        args[i] = new char[it_str->size() + 1];
+        strcpy(args[i], it_str->c_str());
+#if DEBUG_ARGS
+        std::cerr << "args[" << i << "] = " << args[i] << std::endl;
+#endif
+        ++i;
     }
 
-    clang::InputKind input_kind(clang_lang);
-    clang::FrontendOptions &fe_opts = invocation.getFrontendOpts();
-    fe_opts.Inputs.clear();
-    fe_opts.Inputs.emplace_back(input_file, input_kind);
 
-    clang::LangOptions::setLangDefaults(
-        lang_opts, clang_lang, target_triple, lang_specific_includes, requested_std);
+  // 2 - Create a compiler instance
 
-    if (language == ClangToSageTranslator::CPLUSPLUS) {
-        ROSE_ASSERT(lang_opts.CPlusPlus && "Expected C++ mode after setting language defaults");
-    }
+    clang::CompilerInstance * compiler_instance = new clang::CompilerInstance();
 
-    if (enable_cuda) {
-        lang_opts.CUDA = 1;
-    }
-    if (enable_opencl) {
-        lang_opts.OpenCL = 1;
-    }
-    if (enable_openmp) {
-        lang_opts.OpenMP = 1;
-        lang_opts.OpenMPUseTLS = 1;
-    }
-    if (enable_openmp_simd) {
-        lang_opts.OpenMPSimd = 1;
-    }
+    ClangParsedUnit * unit = new ClangParsedUnit();
+    unit->compiler_instance = compiler_instance;
+    unit->language = language;
+    unit->input_file = input_file;
 
-    // Now create file manager with FileSystemOptions from the parsed invocation
-    compiler_instance->createFileManager();
+    // Create diagnostics with instance-specific physical filesystem (avoids global singleton double-free)
+    // Use createPhysicalFileSystem() instead of getRealFileSystem() to avoid sharing the global singleton.
+    // getRealFileSystem() returns a static IntrusiveRefCntPtr that libLLVM.so's global destructor also
+    // tries to clean up, causing double-free. createPhysicalFileSystem() creates a new instance that
+    // CompilerInstance can safely own and destroy.
+    //
+    // Persist the VFS IntrusiveRefCntPtr so it lives beyond createDiagnostics() call.
+    // Otherwise the temporary unique_ptr is destroyed immediately, leaving a dangling reference.
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> vfs = llvm::vfs::createPhysicalFileSystem();
 
-    clang::PreprocessorOptions &pp_opts = compiler_instance->getInvocation().getPreprocessorOpts();
-    if (!lang_specific_includes.empty()) {
-        pp_opts.Includes.insert(pp_opts.Includes.end(),
-                                lang_specific_includes.begin(),
-                                lang_specific_includes.end());
+    // Use IntrusiveRefCntPtr for DiagnosticOptions to manage lifetime properly.
+    // TextDiagnosticPrinter stores a pointer to DiagOpts, so it must outlive the function scope.
+    // IntrusiveRefCntPtr ensures proper reference counting and cleanup.
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> DiagOpts = llvm::makeIntrusiveRefCnt<clang::DiagnosticOptions>();
+    //
+    // When parsing ahead on a worker thread the diagnostics are buffered, and replayed by clang_main() when the file
+    // is translated, so that they come out in command-line order and are not interleaved between files.
+    if (buffer_diagnostics) {
+        unit->diagnostics_stream.reset(new llvm::raw_string_ostream(unit->diagnostics));
     }
+    llvm::raw_ostream & diag_stream = buffer_diagnostics ? *unit->diagnostics_stream : llvm::errs();
+    clang::TextDiagnosticPrinter * diag_printer = new clang::TextDiagnosticPrinter(diag_stream, DiagOpts.get());
+    unit->diagnostic_options = DiagOpts;
+    unit->vfs = vfs;
 
-    // LLVM 20 requires shared_ptr, LLVM 21+ requires reference
-#if LLVM_VERSION_MAJOR >= 21
-    clang::TargetOptions target_options;
-    target_options.Triple = llvm::sys::getDefaultTargetTriple();
-    clang::TargetInfo * target_info = clang::TargetInfo::CreateTargetInfo(compiler_instance->getDiagnostics(), target_options);
-#else
-    auto target_options = std::make_shared<clang::TargetOptions>();
-    target_options->Triple = llvm::sys::getDefaultTargetTriple();
-    clang::TargetInfo * target_info = clang::TargetInfo::CreateTargetInfo(compiler_instance->getDiagnostics(), target_options);
-#endif
-    compiler_instance->setTarget(target_info);
+    // LLVM 20+ API - requires VFS as first parameter
+    compiler_instance->createDiagnostics(*vfs, diag_printer, true);
+
+    // Parse command-line arguments and set up the language, file manager and target
+    llvm::ArrayRef<const char *> argsArrayRef(args, &(args[cnt]));
+    clang::Language clang_lang = clang_configure(compiler_instance, language, argsArrayRef, enable_openmp, enable_openmp_simd);
+
+    clang::InputKind input_kind(clang_lang);
+    clang::FrontendOptions &fe_opts = compiler_instance->getInvocation().getFrontendOpts();
+    fe_opts.Inputs.clear();
+    fe_opts.Inputs.emplace_back(input_file, input_kind);
+
+    // Take the headers included at the start of the file from a precompiled header (-rose:frontend:clang_precompiled_headers);
+    // the implicit includes are in the precompiled header.
+    std::string pch_file;
+    if (!Rose::Cmdline::Frontend::clangPrecompiledHeaders.empty()) {
+        pch_file = clang_precompiled_prefix(input_file, language, argsArrayRef, enable_openmp, enable_openmp_simd);
+    }
+    if (!pch_file.empty()) {
+        clang::PreprocessorOptions &pp_opts = compiler_instance->getInvocation().getPreprocessorOpts();
+        for (it_str = inc_list.begin(); it_str != inc_list.end(); it_str++) {
+            pp_opts.Includes.erase(std::remove(pp_opts.Includes.begin(), pp_opts.Includes.end(), *it_str), pp_opts.Includes.end());
+        }
+        pp_opts.ImplicitPCHInclude = pch_file;
+        compiler_instance->getHeaderSearchOpts().ValidateASTInputFilesContent = true;
+    }
 
     compiler_instance->createSourceManager(compiler_instance->getFileManager());
 
@@ -408,12 +925,29 @@ int clang_main(int argc, char ** argv, SgSourceFile& sageFile) {
 
     if (!compiler_instance->hasASTContext()) compiler_instance->createASTContext();
 
-    compiler_instance->getPreprocessor().getBuiltinInfo().initializeBuiltins(
-        compiler_instance->getPreprocessor().getIdentifierTable(), lang_opts);
+    if (!pch_file.empty()) {
+        compiler_instance->createPCHExternalASTSource(pch_file, clang::DisableValidationForModuleKind::None, false, NULL, false);
+    }
+
+    // As in clang::FrontendAction::BeginSourceFile(), the builtins come from the precompiled header if there is one.
+    if (compiler_instance->getASTContext().getExternalSource() == NULL) {
+        compiler_instance->getPreprocessor().getBuiltinInfo().initializeBuiltins(
+            compiler_instance->getPreprocessor().getIdentifierTable(), compiler_instance->getLangOpts());
+    }
+
+    // Record the comments, directives and tokens of the main file as they are preprocessed, so that
+    // attachPreprocessingInfo() does not lex the file again.
+    if (Rose::Cmdline::Frontend::clangPreprocessingInfo) {
+        clang::Preprocessor & preprocessor = compiler_instance->getPreprocessor();
+        SagePreprocessorRecord * record = new SagePreprocessorRecord(&(compiler_instance->getSourceManager()));
+        preprocessor.addPPCallbacks(std::unique_ptr<clang::PPCallbacks>(record));
+        preprocessor.addCommentHandler(record);
+        unit->preprocessor_record = record;
+    }
 
-    auto translator_ptr = std::make_unique<ClangToSageTranslator>(compiler_instance, language, &sageFile);
-    ClangToSageTranslator* translator = translator_ptr.get();
-    compiler_instance->setASTConsumer(std::move(translator_ptr));
+    // The translation to Sage III is not done from within ParseAST(): clang_main() runs the ClangToSageTranslator over
+    // the complete translation unit afterwards, so that parsing does not touch any ROSE state and can run on a worker.
+    compiler_instance->setASTConsumer(std::make_unique<clang::ASTConsumer>());
 
     if (!compiler_instance->hasSema()) compiler_instance->createSema(clang::TU_Complete, NULL);
 
@@ -425,7 +959,7 @@ int clang_main(int argc, char ** argv, SgSourceFile& sageFile) {
     ROSE_ASSERT (compiler_instance->hasASTContext());
     ROSE_ASSERT (compiler_instance->hasSema());
 
-  // 3 - Translate
+  // 3 - Parse
 
 //  printf ("Calling clang::ParseAST()\n");
 
@@ -436,85 +970,16 @@ int clang_main(int argc, char ** argv, SgSourceFile& sageFile) {
         ROSE_ASSERT(builtin_id.getBuiltinID() != static_cast<unsigned>(clang::Builtin::NotBuiltin) &&
                     "Expected Clang builtins to be initialised for C++ mode");
     }
-    clang::ParseAST(compiler_instance->getPreprocessor(), translator, compiler_instance->getASTContext());
+    clang::ParseAST(compiler_instance->getPreprocessor(), &(compiler_instance->getASTConsumer()), compiler_instance->getASTContext());
     compiler_instance->getDiagnosticClient().EndSourceFile();
 
     // In LLVM 20, get error count from diagnostics directly
-    unsigned numErrors = compiler_instance->getDiagnostics().getNumErrors();
-    if (numErrors > 0) {
-        printf ("Clang found %d diagnostic errors during parsing\n", numErrors);
-    }
-
-    SgGlobal * global_scope = translator->getGlobalScope();
-
-  // 4 - Attach to the file
-
-    if (sageFile.get_globalScope() != NULL) SageInterface::deleteAST(sageFile.get_globalScope());
-
-    sageFile.set_globalScope(global_scope);
-
-    // Parent relationship already set up during global scope creation
-
-    std::string file_name(input_file);
-
-    Sg_File_Info * start_fi = new Sg_File_Info(file_name, 0, 0);
-    Sg_File_Info * end_fi   = new Sg_File_Info(file_name, 0, 0);
-
-    global_scope->set_startOfConstruct(start_fi);
-
-    global_scope->set_endOfConstruct(end_fi);
-
-  // 6 - Initialize token subsequence map for unparsing
-  // The backend unparser expects this map to exist (even if empty) for token-based unparsing
-  // Note: Raw pointer allocation follows ROSE's standard memory management pattern (see tokenStreamMapping.C).
-  // Memory is managed by the global Rose::tokenSubsequenceMapOfMapsBySourceFile map and persists
-  // for the program lifetime, consistent with ROSE's architecture for AST-related data structures.
-  //
-  // Check if a token map already exists (e.g., from a previous parse after deleteAST).
-  // If it exists, clear it for reuse. Otherwise, create a new one.
-    if (Rose::tokenSubsequenceMapOfMapsBySourceFile.find(&sageFile) != Rose::tokenSubsequenceMapOfMapsBySourceFile.end()) {
-        // Map already exists (re-parsing after deleteAST) - clear it for reuse
-        std::map<SgNode*,TokenStreamSequenceToNodeMapping*>* existingMap = Rose::tokenSubsequenceMapOfMapsBySourceFile[&sageFile];
-        if (existingMap != nullptr) {
-            existingMap->clear();
-        }
-    } else {
-        // First time parsing this file - create new map
-        std::map<SgNode*,TokenStreamSequenceToNodeMapping*>* tokenMap = new std::map<SgNode*,TokenStreamSequenceToNodeMapping*>();
-        sageFile.set_tokenSubsequenceMap(tokenMap);
-    }
-
-  // 7 - Finish the AST (fixup phase)
-
-    finishSageAST(*translator);
-
-  // 8 - Cleanup LLVM objects
-  //
-  // Now that we use createPhysicalFileSystem() instead of getRealFileSystem(),
-  // the CompilerInstance owns its own VFS instance rather than sharing the global singleton.
-  // This means we can safely delete the CompilerInstance without causing double-free errors.
-  //
-  // The translator is owned by CompilerInstance via unique_ptr<ASTConsumer>, so it will also
-  // be destroyed when CompilerInstance is deleted. The ROSE AST (global_scope, etc.) persists
-  // in sageFile and is NOT owned by the translator, so it remains valid after cleanup.
-
-    delete compiler_instance;
+    unit->numErrors = compiler_instance->getDiagnostics().getNumErrors();
 
-    // REX: Experimental C++ frontend is permissive - if we successfully built an AST
-    // (valid global_scope), allow backend to run even if Clang reported errors.
-    // This is necessary because Clang may report missing headers or other compilation
-    // errors, but we still want to attempt code generation with the partial AST.
-    if (global_scope != NULL) {
-        if (numErrors > 0) {
-            printf ("Note: Proceeding to backend despite %d Clang diagnostic error(s) because AST was successfully constructed\n", numErrors);
-        }
-        return 0;  // Success - AST was built
-    } else {
-        printf ("Error: Failed to build AST - global_scope is NULL\n");
-        return (numErrors > 0) ? numErrors : 1;  // Failure - no AST
-    }
+    return unit;
 }
 
+
 void finishSageAST(ClangToSageTranslator & translator) {
     SgGlobal * global_scope = translator.getGlobalScope();
 
@@ -549,14 +1014,65 @@ ClangToSageTranslator::ClangToSageTranslator(clang::CompilerInstance * compiler_
     p_global_scope(NULL),
     p_class_type_decl_first_see_in_type(),
     p_enum_type_decl_first_see_in_type(),
+    p_template_decl_cache(),
+    p_template_inst_cache(),
+    p_visit_timing(SgProject::get_verbose() > 0),
+    p_visit_statistics(),
+    p_visit_children_seconds(),
     p_compiler_instance(compiler_instance),
-    p_sage_preprocessor_recorder(new SagePreprocessorRecord(&(p_compiler_instance->getSourceManager()))),
     p_sage_source_file(sage_source_file),
     language(language_)
 {}
 
-ClangToSageTranslator::~ClangToSageTranslator() {
-    delete p_sage_preprocessor_recorder;
+ClangToSageTranslator::~ClangToSageTranslator() {}
+
+/* Per visitor statistics */
+
+ClangToSageTranslator::VisitTimer::VisitTimer(ClangToSageTranslator & translator_, const char * category, const char * kind_) :
+    translator(translator_),
+    kind(category, kind_),
+    start()
+{
+    if (translator.p_visit_timing) {
+        start = std::chrono::steady_clock::now();
+        translator.p_visit_children_seconds.push_back(0.0);
+    }
+}
+
+ClangToSageTranslator::VisitTimer::~VisitTimer() {
+    if (!translator.p_visit_timing) return;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double children_seconds = translator.p_visit_children_seconds.back();
+    translator.p_visit_children_seconds.pop_back();
+    if (!translator.p_visit_children_seconds.empty()) {
+        translator.p_visit_children_seconds.back() += elapsed.count();
+    }
+
+    VisitStatistics & statistics = translator.p_visit_statistics[kind];
+    statistics.visits++;
+    statistics.seconds += elapsed.count() - children_seconds;
+}
+
+void ClangToSageTranslator::countVisitHit(const char * category, const char * kind) {
+    p_visit_statistics[VisitKind(category, kind)].hits++;
+}
+
+void ClangToSageTranslator::reportVisitStatistics(double seconds) {
+    std::vector<std::pair<VisitKind, VisitStatistics> > statistics(p_visit_statistics.begin(), p_visit_statistics.end());
+    std::sort(statistics.begin(), statistics.end(),
+              [](const std::pair<VisitKind, VisitStatistics> & a, const std::pair<VisitKind, VisitStatistics> & b) {
+                  return a.second.seconds > b.second.seconds;
+              });
+
+    printf ("Clang to Sage translation of %s: %.3g s, %u decls, %u stmts and %u types translated\n",
+            p_sage_source_file != NULL ? p_sage_source_file->getFileName().c_str() : "<unknown>", seconds,
+            p_decl_translation_map.size(), p_stmt_translation_map.size(), p_type_translation_map.size());
+    for (size_t i = 0; i < statistics.size(); i++) {
+        const VisitStatistics & s = statistics[i].second;
+        printf ("  %s %-36s %10lu visits %10lu hits %10.3g s\n",
+                statistics[i].first.first, statistics[i].first.second, s.visits, s.hits, s.seconds);
+    }
 }
 
 /* (protected) Helper methods */
@@ -785,198 +1301,590 @@ void ClangToSageTranslator::setCompilerGeneratedFileInfo(SgNode * node, bool to_
 /* Overload of ASTConsumer::HandleTranslationUnit, it is the "entry point" */
 
 void ClangToSageTranslator::HandleTranslationUnit(clang::ASTContext & ast_context) {
+  // Reserve the translation maps so that they are not rehashed while translating: every type of the context can be
+  // translated, and the numbers of declarations and statements are estimated from the memory allocated for the AST
+  // (about 64 bytes per node, a third of them declarations).
+    size_t ast_nodes = ast_context.getASTAllocatedMemory() / 64;
+    p_type_translation_map.reserve(ast_context.getTypes().size());
+    p_decl_translation_map.reserve(ast_nodes / 3);
+    p_stmt_translation_map.reserve(ast_nodes - ast_nodes / 3);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
     Traverse(ast_context.getTranslationUnitDecl());
+
+    if (p_visit_timing) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        reportVisitStatistics(elapsed.count());
+    }
 }
 
-/* Preprocessor Stack */
+// class SagePreprocessorRecord
+
+// Defined by the lexer of the comments and CPP directives (preproc-c.ll)
+extern int identify_if_C_CXX_keyword(std::string str);
+extern int getNumberOfLines(std::string internalString);
+extern int getColumnNumberOfEndOfString(std::string internalString);
 
-std::pair<Sg_File_Info *, PreprocessingInfo *> ClangToSageTranslator::preprocessor_top() {
-    return p_sage_preprocessor_recorder->top();
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t';
 }
 
-bool ClangToSageTranslator::preprocessor_pop() {
-    return p_sage_preprocessor_recorder->pop();
+static bool isIdentifierCharacter(char c) {
+    return std::isalnum((unsigned char)c) || c == '_';
 }
 
-// struct NextPreprocessorToInsert
-
-// NextPreprocessorToInsert::NextPreprocessorToInsert(ClangToSageTranslator & translator_) :
-NextPreprocessorToInsert::NextPreprocessorToInsert(ClangToSageTranslator & translator_) :
-  cursor(NULL),
-  candidat(NULL),
-  next_to_insert(NULL),
-  translator(translator_)
-{}
+static unsigned lineStart(llvm::StringRef buffer, unsigned pos) {
+    while (pos > 0 && buffer[pos - 1] != '\n') pos--;
+    return pos;
+}
 
-NextPreprocessorToInsert * NextPreprocessorToInsert::next() {
-    if (!translator.preprocessor_pop()) return NULL;
+// Start of the first line of the (continued) line that contains pos
+static unsigned logicalLineStart(llvm::StringRef buffer, unsigned pos) {
+    unsigned start = lineStart(buffer, pos);
+    while (start >= 2 && buffer[start - 2] == '\\') start = lineStart(buffer, start - 2);
+    return start;
+}
 
-    NextPreprocessorToInsert * res = new NextPreprocessorToInsert(translator);
+// End of the character or string literal starting at pos (unterminated literals end with the line)
+static unsigned literalEnd(llvm::StringRef buffer, unsigned pos) {
+    char quote = buffer[pos++];
+    while (pos < buffer.size()) {
+        char c = buffer[pos];
+        if (c == '\\') pos += 2;
+        else if (c == quote) return pos + 1;
+        else if (c == '\n') return pos;
+        else pos++;
+    }
+    return buffer.size();
+}
 
-    std::pair<Sg_File_Info *, PreprocessingInfo *> next = translator.preprocessor_top();
-    res->cursor = next.first;
-    res->next_to_insert = next.second;
-    res->candidat = candidat;
-    return res;
+// End of the directive (after its newline) whose '#' is at pos
+static unsigned directiveEnd(llvm::StringRef buffer, unsigned pos) {
+    unsigned size = buffer.size();
+    while (pos < size) {
+        char c = buffer[pos];
+        char next = pos + 1 < size ? buffer[pos + 1] : '\0';
+        if (c == '\n') {
+            return pos + 1;
+        } else if (c == '\\' && next == '\n') {
+            pos += 2;
+        } else if (c == '\\' && next == '\r' && pos + 2 < size && buffer[pos + 2] == '\n') {
+            pos += 3;
+        } else if (c == '/' && next == '*') {
+            size_t close = buffer.find("*/", pos + 2);
+            pos = close == llvm::StringRef::npos ? size : close + 2;
+        } else if (c == '/' && next == '/') {
+            pos += 2;
+            while (pos < size && buffer[pos] != '\n') pos += buffer[pos] == '\\' ? 2 : 1;
+        } else if (c == '"' || c == '\'') {
+            pos = literalEnd(buffer, pos);
+        } else {
+            pos++;
+        }
+    }
+    return size;
 }
 
-// class
+// Name of the directive whose '#' is at pos
+static llvm::StringRef directiveName(llvm::StringRef buffer, unsigned pos) {
+    pos++;
+    while (pos < buffer.size() && isBlank(buffer[pos])) pos++;
+    unsigned end = pos;
+    while (end < buffer.size() && isIdentifierCharacter(buffer[end])) end++;
+    return buffer.substr(pos, end - pos);
+}
 
-NextPreprocessorToInsert * PreprocessorInserter::evaluateInheritedAttribute(SgNode * astNode, NextPreprocessorToInsert * inheritedValue) {
-    SgLocatedNode * loc_node = isSgLocatedNode(astNode);
-    if (loc_node == NULL) return inheritedValue;
+// The kinds are those given by the lexer (preproc-c.ll) which also takes #include_next for an #include, ...
+static int directiveKind(llvm::StringRef name) {
+    if (name == "include" || name == "include_next" || name == "import") return PreprocessingInfo::CpreprocessorIncludeDeclaration;
+    if (name == "define") return PreprocessingInfo::CpreprocessorDefineDeclaration;
+    if (name == "undef") return PreprocessingInfo::CpreprocessorUndefDeclaration;
+    if (name == "line") return PreprocessingInfo::CpreprocessorLineDeclaration;
+    if (name == "error") return PreprocessingInfo::CpreprocessorErrorDeclaration;
+    if (name == "if") return PreprocessingInfo::CpreprocessorIfDeclaration;
+    if (name == "ifdef") return PreprocessingInfo::CpreprocessorIfdefDeclaration;
+    if (name == "ifndef") return PreprocessingInfo::CpreprocessorIfndefDeclaration;
+    if (name == "elif" || name == "elifdef" || name == "elifndef") return PreprocessingInfo::CpreprocessorElifDeclaration;
+    if (name == "else") return PreprocessingInfo::CpreprocessorElseDeclaration;
+    if (name == "endif") return PreprocessingInfo::CpreprocessorEndifDeclaration;
+    if (name == "warning") return PreprocessingInfo::CpreprocessorWarningDeclaration;
+    // # 33 "file.c" (GNU line marker)
+    if (!name.empty() && std::isdigit((unsigned char)name[0])) return PreprocessingInfo::CpreprocessorLineDeclaration;
+    return PreprocessingInfo::CpreprocessorUnknownDeclaration;
+}
 
-    Sg_File_Info * current_pos = loc_node->get_startOfConstruct();
+// End of "#pragma" (the rest of the line is tokenized as by the lexer)
+static unsigned pragmaEnd(llvm::StringRef buffer, unsigned pos) {
+    llvm::StringRef name = directiveName(buffer, pos);
+    return name.data() - buffer.data() + name.size();
+}
 
-    bool passed_cursor = *current_pos > *(inheritedValue->cursor);
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
 
-    if (passed_cursor) {
-        // TODO insert on inheritedValue->candidat
-        return inheritedValue->next();
+// End of the numeric literal of the lexer ((0x|0b)?[0-9]+('[0-9]+)*) starting at pos, so "1.5" or "10L" are several tokens
+static unsigned numberEnd(llvm::StringRef buffer, unsigned pos, unsigned end) {
+    if (pos + 2 < end && buffer[pos] == '0' && (buffer[pos + 1] == 'x' || buffer[pos + 1] == 'b') && isDigit(buffer[pos + 2])) pos += 2;
+    while (pos < end && isDigit(buffer[pos])) {
+        while (pos < end && isDigit(buffer[pos])) pos++;
+        if (pos + 1 < end && buffer[pos] == '\'' && isDigit(buffer[pos + 1])) pos++;
     }
+    return pos;
+}
 
-    return inheritedValue;
+// Length of the syntax token of the lexer at pos, 0 if the lexer skips the character (e.g. '@' or '\\')
+static unsigned syntaxLength(llvm::StringRef buffer, unsigned pos, unsigned end) {
+    static const char * const pairs[] = { "++", "--", "->", "!=", "|=", "<=", ">=" };
+    llvm::StringRef text = buffer.substr(pos, std::min(2u, end - pos));
+    for (const char * pair : pairs) {
+        if (text == pair) return 2;
+    }
+    return buffer[pos] != '\0' && std::strchr("{}();,:.%^~&?*/!|=-+[]#<>", buffer[pos]) != NULL ? 1 : 0;
 }
 
-// class SagePreprocessorRecord
+// End of extern "C" { (or "C++") starting the line at pos as matched by the lexer (mlinkagespecification), pos if none
+static unsigned linkageSpecificationEnd(llvm::StringRef buffer, unsigned pos) {
+    unsigned begin = pos;
+    while (pos < buffer.size() && isBlank(buffer[pos])) pos++;
+    if (!buffer.substr(pos).starts_with("extern")) return begin;
+
+    pos += 6;
+    while (pos < buffer.size() && isBlank(buffer[pos])) pos++;
+    if (buffer.substr(pos).starts_with("\"C\"")) pos += 3;
+    else if (buffer.substr(pos).starts_with("\"C++\"")) pos += 5;
+    else return begin;
+
+    while (pos < buffer.size() && std::isspace((unsigned char)buffer[pos])) pos++;
+    if (pos == buffer.size() || buffer[pos] != '{') return begin;
+    return pos + 1;
+}
 
 SagePreprocessorRecord::SagePreprocessorRecord(clang::SourceManager * source_manager) :
+  clang::PPCallbacks(),
+  clang::CommentHandler(),
   p_source_manager(source_manager),
-  p_preprocessor_record_list()
+  p_elements()
 {}
 
-void SagePreprocessorRecord::InclusionDirective(clang::SourceLocation HashLoc, const clang::Token & IncludeTok, llvm::StringRef FileName, bool IsAngled,
-                                                const clang::FileEntry * File, clang::SourceLocation EndLoc, llvm::StringRef SearchPath, llvm::StringRef RelativePath) {
-    std::cerr << "InclusionDirective" << std::endl;
+bool SagePreprocessorRecord::inMainFile(clang::SourceLocation loc, unsigned & offset) {
+    if (loc.isInvalid() || !loc.isFileID()) return false;
 
-    bool inv_begin_line;
-    bool inv_begin_col;
+    std::pair<clang::FileID, unsigned> decomposed_loc = p_source_manager->getDecomposedLoc(loc);
+    if (decomposed_loc.first != p_source_manager->getMainFileID()) return false;
 
-    unsigned ls = p_source_manager->getSpellingLineNumber(HashLoc, &inv_begin_line);
-    unsigned cs = p_source_manager->getSpellingColumnNumber(HashLoc, &inv_begin_col);
+    offset = decomposed_loc.second;
+    return true;
+}
 
-    // In LLVM 20, getFileEntryForID still returns const FileEntry*
-    std::string file = "";
-    const clang::FileEntry* fileEntry = p_source_manager->getFileEntryForID(p_source_manager->getFileID(HashLoc));
-    if (fileEntry) {
-        // In LLVM 20, FileEntry uses tryGetRealPathName() instead of getName()
-        file = fileEntry->tryGetRealPathName().str();
-    }
+void SagePreprocessorRecord::recordDirective(unsigned offset, int kind) {
+    llvm::StringRef buffer = p_source_manager->getBufferData(p_source_manager->getMainFileID());
+
+    unsigned begin = logicalLineStart(buffer, offset);
+    unsigned pos = begin;
+    while (pos < buffer.size() && isBlank(buffer[pos])) pos++;
+
+    // Only directives starting their line are recognized by the lexer. The pragmas are tokens (see recordPragma()).
+    if (pos == buffer.size() || buffer[pos] != '#' || directiveName(buffer, pos) == "pragma") return;
+
+    Element element = { begin, directiveEnd(buffer, pos), kind, false };
+    p_elements.push_back(element);
+}
 
-    std::cerr << "    In file  : " << file << std::endl;
-    std::cerr << "    From     : " << ls << ":" << cs << std::endl;
-    std::cerr << "    Included : " << FileName.str() << std::endl;
-    std::cerr << "    Is angled: " << (IsAngled ? "T" : "F") << std::endl;
+void SagePreprocessorRecord::recordDirective(clang::SourceLocation loc, int kind) {
+    unsigned offset;
+    if (inMainFile(loc, offset)) recordDirective(offset, kind);
+}
+
+void SagePreprocessorRecord::recordPragma(unsigned offset) {
+    llvm::StringRef buffer = p_source_manager->getBufferData(p_source_manager->getMainFileID());
+
+    unsigned begin = lineStart(buffer, offset);
+    unsigned pos = begin;
+    while (pos < buffer.size() && isBlank(buffer[pos])) pos++;
+    if (pos == buffer.size() || buffer[pos] != '#') return;
+
+    recordToken(begin, pragmaEnd(buffer, pos), ROSE_token_ids::C_CXX_PRAGMA);
+}
+
+void SagePreprocessorRecord::recordToken(unsigned begin, unsigned end, int id) {
+    Element element = { begin, end, id, true };
+    p_elements.push_back(element);
+}
 
-    Sg_File_Info * file_info = new Sg_File_Info(file, ls, cs);
-    PreprocessingInfo * preproc_info = new PreprocessingInfo(
-                                                  PreprocessingInfo::CpreprocessorIncludeDeclaration,
-                                                  FileName.str(),
-                                                  file,
-                                                  ls,
-                                                  cs,
-                                                  0,
-                                                  PreprocessingInfo::before
-                                           );
+// The directives and comments of a block the preprocessor skipped (no callback is invoked for them)
+void SagePreprocessorRecord::scanSkippedRange(unsigned begin, unsigned end) {
+    llvm::StringRef buffer = p_source_manager->getBufferData(p_source_manager->getMainFileID());
+    unsigned size = buffer.size();
+
+    unsigned pos = lineStart(buffer, begin);
+    bool at_line_start = true;
+    while (pos < size && pos <= end) {
+        if (at_line_start) {
+            at_line_start = false;
+
+            unsigned first = pos;
+            while (first < size && isBlank(buffer[first])) first++;
+            if (first < size && buffer[first] == '#') {
+                llvm::StringRef name = directiveName(buffer, first);
+                int kind = directiveKind(name);
+                unsigned directive_end = directiveEnd(buffer, first);
+                if (name == "pragma") {
+                    recordToken(pos, pragmaEnd(buffer, first), ROSE_token_ids::C_CXX_PRAGMA);
+                } else if (kind != PreprocessingInfo::CpreprocessorUnknownDeclaration) {
+                    Element element = { pos, directive_end, kind, false };
+                    p_elements.push_back(element);
+                }
+                pos = directive_end;
+                at_line_start = true;
+                continue;
+            }
+        }
 
-    p_preprocessor_record_list.push_back(std::pair<Sg_File_Info *, PreprocessingInfo *>(file_info, preproc_info));
+        char c = buffer[pos];
+        char next = pos + 1 < size ? buffer[pos + 1] : '\0';
+        if (c == '\n') {
+            pos++;
+            at_line_start = true;
+        } else if (c == '/' && next == '*') {
+            size_t close = buffer.find("*/", pos + 2);
+            unsigned comment_end = close == llvm::StringRef::npos ? size : close + 2;
+            Element element = { pos, comment_end, PreprocessingInfo::C_StyleComment, false };
+            p_elements.push_back(element);
+            pos = comment_end;
+        } else if (c == '/' && next == '/') {
+            unsigned comment_end = pos + 2;
+            while (comment_end < size && buffer[comment_end] != '\n') comment_end += buffer[comment_end] == '\\' ? 2 : 1;
+            if (comment_end < size) comment_end++;
+            Element element = { pos, std::min(comment_end, size), PreprocessingInfo::CplusplusStyleComment, false };
+            p_elements.push_back(element);
+            pos = comment_end;
+            at_line_start = true;
+        } else if (c == '"' || c == '\'') {
+            pos = literalEnd(buffer, pos);
+        } else {
+            pos++;
+        }
+    }
 }
 
-void SagePreprocessorRecord::EndOfMainFile() {
-    std::cerr << "EndOfMainFile" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::InclusionDirective(clang::SourceLocation HashLoc, const clang::Token & IncludeTok, llvm::StringRef FileName, bool IsAngled,
+                                                clang::CharSourceRange FilenameRange, clang::OptionalFileEntryRef File, llvm::StringRef SearchPath,
+                                                llvm::StringRef RelativePath, const clang::Module * SuggestedModule, bool ModuleImported,
+                                                clang::SrcMgr::CharacteristicKind FileType) {
+    recordDirective(HashLoc, PreprocessingInfo::CpreprocessorIncludeDeclaration);
 }
 
-void SagePreprocessorRecord::Ident(clang::SourceLocation Loc, const std::string & str) {
-    std::cerr << "Ident" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::FileChanged(clang::SourceLocation Loc, FileChangeReason Reason, clang::SrcMgr::CharacteristicKind FileType, clang::FileID PrevFID) {
+    // #line (and GNU line markers): Loc follows the newline of the directive
+    unsigned offset;
+    if (Reason == RenameFile && inMainFile(Loc, offset) && offset > 0) {
+        recordDirective(offset - 1, PreprocessingInfo::CpreprocessorLineDeclaration);
+    }
 }
 
-void SagePreprocessorRecord::PragmaComment(clang::SourceLocation Loc, const clang::IdentifierInfo * Kind, const std::string & Str) {
-    std::cerr << "PragmaComment" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::PragmaDirective(clang::SourceLocation Loc, clang::PragmaIntroducerKind Introducer) {
+    unsigned offset;
+    if (Introducer == clang::PIK_HashPragma && inMainFile(Loc, offset)) recordPragma(offset);
 }
 
-void SagePreprocessorRecord::PragmaMessage(clang::SourceLocation Loc, llvm::StringRef Str) {
-    std::cerr << "PragmaMessage" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::MacroDefined(const clang::Token & MacroNameTok, const clang::MacroDirective * MD) {
+    recordDirective(MacroNameTok.getLocation(), PreprocessingInfo::CpreprocessorDefineDeclaration);
 }
 
-void SagePreprocessorRecord::PragmaDiagnosticPush(clang::SourceLocation Loc, llvm::StringRef Namespace) {
-    std::cerr << "PragmaDiagnosticPush" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::MacroUndefined(const clang::Token & MacroNameTok, const clang::MacroDefinition & MD, const clang::MacroDirective * Undef) {
+    recordDirective(MacroNameTok.getLocation(), PreprocessingInfo::CpreprocessorUndefDeclaration);
 }
 
-void SagePreprocessorRecord::PragmaDiagnosticPop(clang::SourceLocation Loc, llvm::StringRef Namespace) {
-    std::cerr << "PragmaDiagnosticPop" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::SourceRangeSkipped(clang::SourceRange Range, clang::SourceLocation EndifLoc) {
+    unsigned begin, end;
+    if (inMainFile(Range.getBegin(), begin) && inMainFile(Range.getEnd(), end)) scanSkippedRange(begin, end);
 }
 
-void SagePreprocessorRecord::PragmaDiagnostic(clang::SourceLocation Loc, llvm::StringRef Namespace, clang::diag::Severity Severity, llvm::StringRef Str) {
-    std::cerr << "PragmaDiagnostic" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::If(clang::SourceLocation Loc, clang::SourceRange ConditionRange, ConditionValueKind ConditionValue) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorIfDeclaration);
 }
 
-void SagePreprocessorRecord::MacroExpands(const clang::Token & MacroNameTok, const clang::MacroInfo * MI, clang::SourceRange Range) {
-    std::cerr << "MacroExpands" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Elif(clang::SourceLocation Loc, clang::SourceRange ConditionRange, ConditionValueKind ConditionValue, clang::SourceLocation IfLoc) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorElifDeclaration);
 }
 
-void SagePreprocessorRecord::MacroDefined(const clang::Token & MacroNameTok, const clang::MacroInfo * MI) {
-    std::cerr << "" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Ifdef(clang::SourceLocation Loc, const clang::Token & MacroNameTok, const clang::MacroDefinition & MD) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorIfdefDeclaration);
 }
 
-void SagePreprocessorRecord::MacroUndefined(const clang::Token & MacroNameTok, const clang::MacroInfo * MI) {
-    std::cerr << "MacroUndefined" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Elifdef(clang::SourceLocation Loc, const clang::Token & MacroNameTok, const clang::MacroDefinition & MD) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorElifDeclaration);
 }
 
-void SagePreprocessorRecord::Defined(const clang::Token & MacroNameTok) {
-    std::cerr << "Defined" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Elifdef(clang::SourceLocation Loc, clang::SourceRange ConditionRange, clang::SourceLocation IfLoc) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorElifDeclaration);
 }
 
-void SagePreprocessorRecord::SourceRangeSkipped(clang::SourceRange Range) {
-    std::cerr << "SourceRangeSkipped" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Ifndef(clang::SourceLocation Loc, const clang::Token & MacroNameTok, const clang::MacroDefinition & MD) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorIfndefDeclaration);
 }
 
-void SagePreprocessorRecord::If(clang::SourceRange Range) {
-    std::cerr << "If" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Elifndef(clang::SourceLocation Loc, const clang::Token & MacroNameTok, const clang::MacroDefinition & MD) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorElifDeclaration);
 }
 
-void SagePreprocessorRecord::Elif(clang::SourceRange Range) {
-    std::cerr << "Elif" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Elifndef(clang::SourceLocation Loc, clang::SourceRange ConditionRange, clang::SourceLocation IfLoc) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorElifDeclaration);
 }
 
-void SagePreprocessorRecord::Ifdef(const clang::Token & MacroNameTok) {
-    std::cerr << "Ifdef" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Else(clang::SourceLocation Loc, clang::SourceLocation IfLoc) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorElseDeclaration);
 }
 
-void SagePreprocessorRecord::Ifndef(const clang::Token & MacroNameTok) {
-    std::cerr << "Ifndef" << std::endl;
-    ROSE_ABORT();
+void SagePreprocessorRecord::Endif(clang::SourceLocation Loc, clang::SourceLocation IfLoc) {
+    recordDirective(Loc, PreprocessingInfo::CpreprocessorEndifDeclaration);
 }
 
-void SagePreprocessorRecord::Else() {
-    std::cerr << "Else" << std::endl;
-    ROSE_ABORT();
+bool SagePreprocessorRecord::HandleComment(clang::Preprocessor & PP, clang::SourceRange Comment) {
+    unsigned begin, end;
+    if (!inMainFile(Comment.getBegin(), begin) || !inMainFile(Comment.getEnd(), end)) return false;
+
+    llvm::StringRef buffer = p_source_manager->getBufferData(p_source_manager->getMainFileID());
+
+    int kind = PreprocessingInfo::C_StyleComment;
+    if (buffer.substr(begin, 2) == "//") {
+        // As for the lexer, a C++ comment includes its newline
+        kind = PreprocessingInfo::CplusplusStyleComment;
+        if (end < buffer.size() && buffer[end] == '\r') end++;
+        if (end < buffer.size() && buffer[end] == '\n') end++;
+    }
+
+    Element element = { begin, end, kind, false };
+    p_elements.push_back(element);
+
+    return false;
 }
 
-void SagePreprocessorRecord::Endif() {
-    std::cerr << "Endif" << std::endl;
-    ROSE_ABORT();
+// Order of the elements in the main file, the directive or comment of a position before its token
+static bool elementBefore(const SagePreprocessorRecord::Element & lhs, const SagePreprocessorRecord::Element & rhs) {
+    if (lhs.begin != rhs.begin) return lhs.begin < rhs.begin;
+    return !lhs.is_token && rhs.is_token;
 }
 
-std::pair<Sg_File_Info *, PreprocessingInfo *> SagePreprocessorRecord::top() {
-    return p_preprocessor_record_list.front();
+/* Builds the list of attributes and the token stream of a file as the lexer (preproc-c.ll) does */
+
+namespace {
+    struct AttributesListBuilder {
+        llvm::StringRef buffer;
+        std::string filename;
+        ROSEAttributesList * attributes;
+        LexTokenStreamType * tokens;
+
+        unsigned cursor;
+        int line;
+        int column;
+
+        // Depth of the braces within a linkage specification, and the depth of the '{' of each open one
+        int brace_depth;
+        std::vector<int> linkage_braces;
+
+        AttributesListBuilder(llvm::StringRef buffer_, const std::string & filename_) :
+          buffer(buffer_), filename(filename_), attributes(new ROSEAttributesList()), tokens(new LexTokenStreamType()),
+          cursor(0), line(1), column(1), brace_depth(0), linkage_braces()
+        {}
+
+        void advance(unsigned end) {
+            for (; cursor < end; cursor++) {
+                if (buffer[cursor] == '\n') {
+                    line++;
+                    column = 1;
+                } else {
+                    column++;
+                }
+            }
+        }
+
+        void addStreamElement(const std::string & lexeme, int id, PreprocessingInfo * info) {
+            token_element * p_tok_elem = new token_element;
+            p_tok_elem->token_lexeme = lexeme;
+            p_tok_elem->token_id = id;
+
+            stream_element * p_se = new stream_element;
+            p_se->p_tok_elem = p_tok_elem;
+            p_se->p_preprocessingInfo = info;
+
+            int number_of_lines = getNumberOfLines(lexeme);
+            int last_string_length = getColumnNumberOfEndOfString(lexeme);
+
+            p_se->beginning_fpi.line_num = line;
+            p_se->beginning_fpi.column_num = column;
+            p_se->ending_fpi.line_num = line + number_of_lines;
+            p_se->ending_fpi.column_num = number_of_lines == 0 ? (column - 1) + (last_string_length - 1) : last_string_length - 1;
+
+            tokens->push_back(p_se);
+        }
+
+        // As add_token() of the lexer: a keyword has its own id, a token that is not syntax or whitespace is an identifier
+        void addToken(unsigned begin, unsigned end, int id) {
+            std::string lexeme = buffer.substr(begin, end - begin).str();
+            int keyword = identify_if_C_CXX_keyword(lexeme);
+            if (keyword != -1) {
+                id = keyword;
+            } else if (id != ROSE_token_ids::C_CXX_SYNTAX && id != ROSE_token_ids::C_CXX_WHITESPACE) {
+                id = ROSE_token_ids::C_CXX_IDENTIFIER;
+            }
+
+            addStreamElement(lexeme, id, NULL);
+            advance(end);
+        }
+
+        void addDirective(unsigned begin, unsigned end, int kind) {
+            std::string text = buffer.substr(begin, end - begin).str();
+            attributes->addElement((PreprocessingInfo::DirectiveType) kind, text, filename, line, column, getNumberOfLines(text));
+
+            PreprocessingInfo * info = attributes->lastElement();
+            addStreamElement(info->getString(), ROSE_token_ids::C_CXX_PREPROCESSING_INFO, info);
+            advance(end);
+        }
+
+        // extern "C" { is a single token, its '}' is a ClinkageSpecificationEnd in the token stream. As in the lexer, the
+        // token is on the line of the '{' and the column then moves by the length of the text.
+        void addLinkageSpecificationStart(unsigned begin, unsigned end) {
+            std::string text = buffer.substr(begin, end - begin).str();
+            attributes->addElement(PreprocessingInfo::ClinkageSpecificationStart, text, filename, line, column, 0);
+
+            line += std::count(text.begin(), text.end(), '\n');
+            addStreamElement(text, ROSE_token_ids::C_CXX_IDENTIFIER, NULL);
+            column += text.size();
+            cursor = end;
+
+            linkage_braces.push_back(++brace_depth);
+        }
+
+        void addBrace(unsigned pos) {
+            if (linkage_braces.empty()) {
+                addToken(pos, pos + 1, ROSE_token_ids::C_CXX_SYNTAX);
+            } else if (buffer[pos] == '{') {
+                brace_depth++;
+                addToken(pos, pos + 1, ROSE_token_ids::C_CXX_SYNTAX);
+            } else if (brace_depth-- == linkage_braces.back()) {
+                linkage_braces.pop_back();
+                addDirective(pos, pos + 1, PreprocessingInfo::ClinkageSpecificationEnd);
+            } else {
+                addToken(pos, pos + 1, ROSE_token_ids::C_CXX_SYNTAX);
+            }
+        }
+
+        // A token for each character or escape sequence and for the quotes, the newlines are tokens in a string
+        // literal but not in a character literal
+        void addLiteral(unsigned end) {
+            char quote = buffer[cursor];
+            addToken(cursor, cursor + 1, ROSE_token_ids::C_CXX_IDENTIFIER);
+
+            while (cursor < end) {
+                unsigned pos = cursor;
+                char c = buffer[pos];
+                char next = pos + 1 < end ? buffer[pos + 1] : '\0';
+
+                unsigned length = 1;
+                if (c == quote) {
+                    addToken(pos, pos + 1, ROSE_token_ids::C_CXX_IDENTIFIER);
+                    return;
+                } else if (c == '\\' && next == '\r' && pos + 2 < end && buffer[pos + 2] == '\n') {
+                    length = 3;
+                } else if ((c == '\\' && pos + 1 < end) || (c == '\r' && next == '\n')) {
+                    length = 2;
+                } else if (c == '\r') {
+                    // No rule of the lexer matches it
+                    cursor++;
+                    continue;
+                }
+
+                if (quote == '\'' && buffer[pos + length - 1] == '\n') {
+                    advance(pos + length);
+                } else {
+                    addToken(pos, pos + length, ROSE_token_ids::C_CXX_IDENTIFIER);
+                }
+            }
+        }
+
+        // Tokenize the text up to end that is not a recorded directive or comment as the lexer (preproc-c.ll) does
+        void gap(unsigned end) {
+            while (cursor < end) {
+                unsigned pos = cursor;
+                char c = buffer[pos];
+
+                if (pos == 0 || buffer[pos - 1] == '\n') {
+                    unsigned first = pos;
+                    while (first < end && isBlank(buffer[first])) first++;
+                    if (first < end && buffer[first] == '#') {
+                        llvm::StringRef name = directiveName(buffer, first);
+                        int kind = directiveKind(name);
+                        if (name == "pragma") {
+                            addToken(pos, pragmaEnd(buffer, first), ROSE_token_ids::C_CXX_PRAGMA);
+                            continue;
+                        } else if (kind != PreprocessingInfo::CpreprocessorUnknownDeclaration) {
+                            addDirective(pos, directiveEnd(buffer, first), kind);
+                            continue;
+                        }
+                    }
+
+                    unsigned linkage_end = linkageSpecificationEnd(buffer, pos);
+                    if (linkage_end != pos && linkage_end <= end) {
+                        addLinkageSpecificationStart(pos, linkage_end);
+                        continue;
+                    }
+                }
+
+                if (c == '\r' && pos + 1 < end && buffer[pos + 1] == '\n') {
+                    addToken(pos, pos + 2, ROSE_token_ids::C_CXX_WHITESPACE);
+                } else if (c == '\n' || c == '\f') {
+                    addToken(pos, pos + 1, ROSE_token_ids::C_CXX_WHITESPACE);
+                } else if (isBlank(c)) {
+                    while (pos < end && isBlank(buffer[pos])) pos++;
+                    addToken(cursor, pos, ROSE_token_ids::C_CXX_WHITESPACE);
+                } else if (std::isalpha((unsigned char)c) || c == '_') {
+                    while (pos < end && isIdentifierCharacter(buffer[pos])) pos++;
+                    addToken(cursor, pos, ROSE_token_ids::C_CXX_IDENTIFIER);
+                } else if (isDigit(c)) {
+                    addToken(pos, numberEnd(buffer, pos, end), ROSE_token_ids::C_CXX_IDENTIFIER);
+                } else if (c == '"' || c == '\'') {
+                    addLiteral(end);
+                } else if (c == '{' || c == '}') {
+                    addBrace(pos);
+                } else if (unsigned length = syntaxLength(buffer, pos, end)) {
+                    addToken(pos, pos + length, ROSE_token_ids::C_CXX_SYNTAX);
+                } else {
+                    advance(pos + 1);
+                }
+            }
+        }
+    };
 }
 
-bool SagePreprocessorRecord::pop() {
-    p_preprocessor_record_list.erase(p_preprocessor_record_list.begin());
-    return !p_preprocessor_record_list.empty();
+ROSEAttributesList * SagePreprocessorRecord::buildListOfAttributes(const std::string & filename) {
+    llvm::StringRef buffer = p_source_manager->getBufferData(p_source_manager->getMainFileID());
+
+    std::stable_sort(p_elements.begin(), p_elements.end(), elementBefore);
+
+    // Elements starting before the cursor are within a directive or comment, or were recorded twice (the directives
+    // closing a skipped block are also scanned)
+    AttributesListBuilder builder(buffer, filename);
+    for (const Element & element : p_elements) {
+        if (element.begin < builder.cursor) continue;
+
+        builder.gap(element.begin);
+        if (element.begin < builder.cursor) continue;
+
+        if (element.is_token) {
+            builder.addToken(element.begin, element.end, element.kind);
+        } else {
+            builder.addDirective(element.begin, element.end, element.kind);
+        }
+    }
+    builder.gap(buffer.size());
+
+    p_elements.clear();
+
+    builder.attributes->set_rawTokenStream(builder.tokens);
+    builder.attributes->setFileName(filename);
+
+    return builder.attributes;
 }
@@ -2,10 +2,21 @@
 #ifndef _CLANG_FRONTEND_HPP_
 # define _CLANG_FRONTEND_HPP_
 
+#include <string>
+#include <utility>
+#include <vector>
+
 class SgSourceFile;
 
 int clang_main(int argc, char* argv[], SgSourceFile& sageFile);
 
+// Parse the given files with Clang on up to "jobs" worker threads. Each file's Clang AST is then claimed by
+// clang_main() when that file is translated, so the translation to Sage III itself remains serial.
+void clang_preparse(const std::vector<std::pair<SgSourceFile*, std::vector<std::string> > > & files, int jobs);
+
+// Join the clang_preparse() workers and release the Clang ASTs of files that were never translated.
+void clang_preparse_finish();
+
 // DQ (11/1/2020): Adding DOD graph support.
 int clang_to_dot_main(int argc, char* argv[]);
 
@@ -0,0 +1,378 @@
+#ifndef ROSE_AST_FILE_IO_H
+#define ROSE_AST_FILE_IO_H
+
+/* Binary AST file I/O.
+
+   writeASTToFile() saves every IR node in the memory pools (the AST of all files of the project, including the symbol
+   tables, the types, the Sg_File_Info objects and the attached comments and CPP directives) to a binary file, and
+   readASTFromFile() rebuilds the AST from such a file without running the frontend again.
+
+   The serialization code for each IR node is generated by ROSETTA (Cxx_GrammarAstFileIO.C): every data member of an IR
+   node is passed to an Archive, which either writes it to the file or reads it back.  Pointers to IR nodes are written as
+   indices (the IR nodes of each variant are numbered in memory pool order).  The reader maps the file into memory, builds
+   all IR nodes of the file in one pass (using the constructor taking a LoadTag, which does not build any other IR nodes),
+   and then restores their data members in a second pass, where each pointer is resolved by a lookup in a vector.  The
+   cost of reading is therefore linear in the number of IR nodes and does not depend on the size of the parsed headers.
+
+   A reader which finds truncated or corrupt data records the error (see Archive::failed()), readASTFromFile() then
+   deletes the IR nodes it built and returns NULL.  If an AST was built or read before in the same process, the builtin
+   type singletons and the global type tables of the process are kept: the ones read from the file are merged into
+   them (their symbols and typedefs are moved) and deleted, and the pointers to them are replaced.
+
+   Not saved are AST attributes (AstAttributeMechanism), output streams, untyped pointers, the hash maps of the SgGraph
+   IR nodes and static caches (e.g. the mangled name caches), which are rebuilt on demand.  Files are only readable by a
+   librose built from the same grammar (checked using grammarSignature()).
+
+   This header requires the declarations of the IR nodes (include "sage3basic.h" or "rose.h" first).
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class PreprocessingInfo;
+class rose_hash_multimap;
+
+namespace AST_FILE_IO
+   {
+  //! Writes all IR nodes in the memory pools to the binary AST file \p fileName.
+     ROSE_DLL_API void writeASTToFile ( const std::string & fileName );
+
+  /*! \brief Reads the binary AST file \p fileName and returns its SgProject.
+
+      The IR nodes are added to the memory pools.  Returns NULL (after reporting the problem) if the file
+      can not be read, is truncated or corrupt, or was written by a librose built from a different grammar;
+      the memory pools and the static IR nodes are then left as they were.
+   */
+     ROSE_DLL_API SgProject* readASTFromFile ( const std::string & fileName );
+
+  //! Selects the constructor of the IR nodes used by the AST file reader.
+     struct LoadTag {};
+
+  /*! \brief Writes or reads the data members of IR nodes.
+
+      The same serializeDataMembers() function of each IR node is used for writing and for reading, so the
+      overloads of field() must consume exactly what they produce.
+   */
+     class ROSE_DLL_API Archive
+        {
+          public:
+            // Writer, IR node nodes[i] is written as the index i+1 (0 is the NULL pointer).
+               Archive ( FILE* file, const std::vector<SgNode*> & nodes );
+
+            // Reader for the buffer [begin,end), fileIdMap maps the file ids of the file to the ids of this process.
+               Archive ( const char* begin, const char* end, const std::vector<SgNode*> & nodes, const std::vector<int> & fileIdMap );
+
+              ~Archive();
+
+               bool isLoading() const { return p_loading; }
+
+            // Scalars, enums, POD structs and IR nodes held by value (the modifiers).
+               template <class T> void field ( T & x );
+
+            // Pointers to IR nodes and owned pointers to STL containers.
+               template <class T> void field ( T* & x );
+
+               void field ( std::string & x );
+               void field ( SgName & x );
+               void field ( char* & x );
+               void field ( const char* & x );
+               void field ( PreprocessingInfo* & x );
+               void field ( rose_hash_multimap* & x );
+
+               template <class T, class A> void field ( std::vector<T,A> & x );
+               template <class A> void field ( std::vector<bool,A> & x );
+               template <class T, class A> void field ( std::list<T,A> & x );
+               template <class K, class C, class A> void field ( std::set<K,C,A> & x );
+               template <class K, class V, class C, class A> void field ( std::map<K,V,C,A> & x );
+               template <class K, class V, class C, class A> void field ( std::multimap<K,V,C,A> & x );
+               template <class F, class S> void field ( std::pair<F,S> & x );
+
+            // Static pointers to IR nodes (builtin types, global tables).  The reader keeps the value if already set,
+            // the IR node read for it is then listed by staticNodeReplacements().
+               template <class T> void staticField ( T* & x );
+
+            // IR nodes read for statics which were already set, mapped to the IR nodes of this process which replace them.
+               const std::map<SgNode*,SgNode*> & staticNodeReplacements() const { return p_staticNodeReplacements; }
+
+            // Resets the statics set by the reader to NULL (used when the file can not be read).
+               void resetStaticDataMembers();
+
+            // File ids (indices into the Sg_File_Info filename table) are remapped by the reader.
+               void fileId ( int & x );
+               void fileId ( std::vector<int> & x );
+
+               void bytes ( void* data, size_t size );
+               size_t count ( size_t n );
+
+            // Flushes the output buffer of the writer.
+               void flush();
+
+            // Number of pointers to IR nodes not in the memory pools (written as NULL).
+               size_t numberOfDanglingPointers() const { return p_danglingPointers; }
+
+            // True if the reader consumed the whole buffer.
+               bool atEnd() const { return p_cursor == p_end; }
+
+            // True if the reader found truncated or corrupt data, it then reads zeros and NULL pointers.
+               bool failed() const { return p_failed; }
+
+          private:
+               void     fail();
+               uint64_t nodeIndex ( SgNode* node );
+               SgNode*  nodeFromIndex ( uint64_t index );
+               void     varint ( uint64_t & x );
+
+               bool p_loading;
+
+            // Writer state
+               FILE* p_file;
+               std::string p_buffer;
+               std::unordered_map<SgNode*,uint64_t> p_nodeIndices;
+               std::unordered_map<PreprocessingInfo*,uint64_t> p_preprocessingInfoIndices;
+               size_t p_danglingPointers;
+
+            // Reader state
+               const char* p_cursor;
+               const char* p_end;
+               const std::vector<SgNode*>* p_nodes;
+               const std::vector<int>* p_fileIdMap;
+               std::vector<PreprocessingInfo*> p_preprocessingInfos;
+               std::map<SgNode*,SgNode*> p_staticNodeReplacements;
+               std::vector<std::function<void()> > p_staticResets;
+               bool p_failed;
+        };
+
+  // Generated by ROSETTA (Cxx_GrammarAstFileIO.C)
+     SgNode* createEmptyNode ( VariantT variant );
+     void serializeStaticDataMembers ( Archive & archive );
+     uint64_t grammarSignature();
+
+  // Abstract IR node classes have no instances in the memory pools.
+     template <class T>
+     SgNode* newEmptyNode()
+        {
+          if constexpr (std::is_abstract<T>::value)
+               return NULL;
+            else
+               return new T(LoadTag());
+        }
+
+     template <class T>
+     void
+     Archive::field ( T & x )
+        {
+          if constexpr (std::is_base_of<SgNode,T>::value)
+             {
+               x.serializeDataMembers(*this);
+             }
+            else
+             {
+               static_assert(std::is_trivially_copyable<T>::value, "AST_FILE_IO::Archive: unsupported data member type");
+               bytes(&x,sizeof(T));
+             }
+        }
+
+     template <class T>
+     void
+     Archive::field ( T* & x )
+        {
+          if constexpr (std::is_base_of<SgNode,T>::value)
+             {
+               uint64_t index = p_loading ? 0 : nodeIndex(x);
+               varint(index);
+               if (p_loading == true)
+                    x = static_cast<T*>(nodeFromIndex(index));
+             }
+            else if constexpr (std::is_class<T>::value)
+             {
+               bool present = (x != NULL);
+               field(present);
+               if (p_loading == true)
+                    x = present ? new T() : NULL;
+               if (present == true)
+                    field(*x);
+             }
+            else
+             {
+            // Pointers to anything else are not owned by the AST.
+               if (p_loading == true)
+                    x = NULL;
+             }
+        }
+
+     template <class T, class A>
+     void
+     Archive::field ( std::vector<T,A> & x )
+        {
+          size_t n = count(x.size());
+          if (p_loading == true)
+               x.resize(n);
+
+          if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value)
+             {
+               bytes(x.data(),n * sizeof(T));
+             }
+            else
+             {
+               for (size_t i = 0; i < n; i++)
+                    field(x[i]);
+             }
+        }
+
+     template <class A>
+     void
+     Archive::field ( std::vector<bool,A> & x )
+        {
+          size_t n = count(x.size());
+          if (p_loading == true)
+               x.assign(n,false);
+
+          for (size_t i = 0; i < n; i++)
+             {
+               bool value = x[i];
+               field(value);
+               x[i] = value;
+             }
+        }
+
+     template <class T, class A>
+     void
+     Archive::field ( std::list<T,A> & x )
+        {
+          size_t n = count(x.size());
+          if (p_loading == true)
+               x.resize(n);
+
+          for (typename std::list<T,A>::iterator i = x.begin(); i != x.end(); i++)
+               field(*i);
+        }
+
+     template <class K, class C, class A>
+     void
+     Archive::field ( std::set<K,C,A> & x )
+        {
+          size_t n = count(x.size());
+          if (p_loading == true)
+             {
+               x.clear();
+               for (size_t i = 0; i < n; i++)
+                  {
+                    K key = K();
+                    field(key);
+                    x.insert(key);
+                  }
+             }
+            else
+             {
+               for (typename std::set<K,C,A>::const_iterator i = x.begin(); i != x.end(); i++)
+                  {
+                    K key = *i;
+                    field(key);
+                  }
+             }
+        }
+
+     template <class K, class V, class C, class A>
+     void
+     Archive::field ( std::map<K,V,C,A> & x )
+        {
+          size_t n = count(x.size());
+          if (p_loading == true)
+             {
+               x.clear();
+               for (size_t i = 0; i < n; i++)
+                  {
+                    std::pair<K,V> element = std::pair<K,V>();
+                    field(element);
+                    x.insert(element);
+                  }
+             }
+            else
+             {
+               for (typename std::map<K,V,C,A>::iterator i = x.begin(); i != x.end(); i++)
+                  {
+                    K key = i->first;
+                    field(key);
+                    field(i->second);
+                  }
+             }
+        }
+
+     template <class K, class V, class C, class A>
+     void
+     Archive::field ( std::multimap<K,V,C,A> & x )
+        {
+          size_t n = count(x.size());
+          if (p_loading == true)
+             {
+               x.clear();
+               for (size_t i = 0; i < n; i++)
+                  {
+                    std::pair<K,V> element = std::pair<K,V>();
+                    field(element);
+                    x.insert(x.end(),element);
+                  }
+             }
+            else
+             {
+               for (typename std::multimap<K,V,C,A>::iterator i = x.begin(); i != x.end(); i++)
+                  {
+                    K key = i->first;
+                    field(key);
+                    field(i->second);
+                  }
+             }
+        }
+
+     template <class F, class S>
+     void
+     Archive::field ( std::pair<F,S> & x )
+        {
+          field(x.first);
+          field(x.second);
+        }
+
+     template <class T>
+     void
+     Archive::staticField ( T* & x )
+        {
+          if (p_loading == false)
+             {
+               field(x);
+               return;
+             }
+
+          uint64_t index = 0;
+          varint(index);
+          SgNode* node = nodeFromIndex(index);
+          if (node == NULL || node == x)
+               return;
+
+          if (node->variantT() != (VariantT) T::static_variant)
+             {
+               fail();
+               return;
+             }
+
+          if (x == NULL)
+             {
+               x = static_cast<T*>(node);
+               p_staticResets.push_back([&x]() { x = NULL; });
+             }
+            else
+             {
+               p_staticNodeReplacements[node] = x;
+             }
+        }
+   }
+
+#endif
@@ -9,5 +9,20 @@
  *  compiler-generated. */
 size_t checkIsCompilerGeneratedFlag(SgNode *ast);
 
+/** Traversal used by checkIsCompilerGeneratedFlag().
+ *
+ *  Exposed so that it can be combined with other post-processing traversals (see AstPostProcessing()).  Within a combined
+ *  traversal it must be visited after CheckIsFrontendSpecificFlag. */
+class CheckIsCompilerGeneratedFlag: public AstSimpleProcessing {
+public:
+    size_t nviolations;
+    CheckIsCompilerGeneratedFlag(): nviolations(0) {}
+
+    void visit(SgNode *node);
+
+private:
+    void fix(SgNode *node, Sg_File_Info *finfo);
+};
+
 #endif
 
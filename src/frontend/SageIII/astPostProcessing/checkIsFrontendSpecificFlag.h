@@ -7,5 +7,22 @@
  *  in the AST that is frontend-specific.   All violations are fixed in place.  Returns the number of violations found/fixed. */
 size_t checkIsFrontendSpecificFlag(SgNode *ast);
 
+/** Traversal used by checkIsFrontendSpecificFlag().
+ *
+ *  Exposed so that it can be combined with other post-processing traversals (see AstPostProcessing()). */
+class CheckIsFrontendSpecificFlag: public AstPrePostProcessing {
+public:
+    SgNode *fes_ast; // top node of frontend-specific AST
+    size_t nviolations;
+    CheckIsFrontendSpecificFlag(): fes_ast(NULL), nviolations(0) {}
+
+    void preOrderVisit(SgNode *node);
+    void postOrderVisit(SgNode *node);
+
+private:
+    bool is_frontend_specific(Sg_File_Info *finfo);
+    void fix(SgNode *node, Sg_File_Info *finfo);
+};
+
 
 #endif
@@ -7,5 +7,20 @@
  *  */
 size_t checkPhysicalSourcePosition(SgNode *ast);
 
+/** Traversal used by checkPhysicalSourcePosition().
+ *
+ *  Exposed so that it can be combined with other post-processing traversals (see AstPostProcessing()). */
+class CheckPhysicalSourcePosition: public AstSimpleProcessing 
+   {
+     public:
+          size_t nviolations;
+          CheckPhysicalSourcePosition(): nviolations(0) {}
+
+          void visit(SgNode *node);
+
+     private:
+          void check(SgNode *node, Sg_File_Info *finfo);
+   };
+
 #endif
 
@@ -9,5 +9,17 @@
  *  */
 size_t fixupFileInfoInconsistanties(SgNode *ast);
 
+/** Traversal used by fixupFileInfoInconsistanties().
+ *
+ *  Exposed so that it can be combined with other post-processing traversals (see AstPostProcessing()). */
+class FixupFileInfoInconsistanties: public AstSimpleProcessing 
+   {
+     public:
+          size_t nviolations;
+          FixupFileInfoInconsistanties(): nviolations(0) {}
+
+          void visit(SgNode *node);
+   };
+
 #endif
 
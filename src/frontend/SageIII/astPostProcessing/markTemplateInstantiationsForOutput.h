@@ -42,6 +42,10 @@ class MarkTemplateInstantiationsForOutputSupport
        // of required definitions.
           std::list<SgDeclarationStatement*> listOfTemplateDeclarationsToOutput;
 
+       // The declarations in listOfTemplateDeclarationsToOutput (so that saveDeclaration() and the
+       // prelink iterations of BuildSetOfRequiredTemplateDeclarations() don't search the list).
+          std::set<SgDeclarationStatement*> setOfTemplateDeclarationsToOutput;
+
       //! Constructor to provide access to file's backend specific template instantiation options
           MarkTemplateInstantiationsForOutputSupport(SgSourceFile* file);
 
@@ -31,6 +31,12 @@ ROSEAttributesList *getPreprocessorDirectives( std::string fileName, std::string
 // void attachPreprocessingInfo(SgSourceFile *sageFile);
 void attachPreprocessingInfo(SgSourceFile *sageFile, const std::string & new_filename = "");
 
+// The comments, CPP directives and token stream of a file recorded by the frontend while it preprocessed the file
+// (-rose:frontend:clang_preprocessing_info). attachPreprocessingInfo() takes them (once) instead of calling
+// getPreprocessorDirectives() on the file.
+void setPreprocessorDirectivesFromFrontend( SgSourceFile* sourceFile, ROSEAttributesList* listOfAttributes );
+ROSEAttributesList* takePreprocessorDirectivesFromFrontend( SgSourceFile* sourceFile );
+
 
 #if 0
 // DQ (12/16/2008): comment out while I debug the non-wave support.
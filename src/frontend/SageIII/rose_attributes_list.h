@@ -589,6 +589,27 @@ class ROSEAttributesListContainer
           void display ( const std::string & label );          // DQ 02/18/2001 -- For debugging.
    };
 
+//
+// Cache of the comments, CPP directives and tokens of the header files, shared by all the source files of the process.
+// Files are keyed by the hash of their contents, so a header included by many translation units is lexed only once.
+// When a cache directory is set (-rose:frontend:preprocessing_info_cache DIR) the lists are also kept between runs.
+//
+class ROSE_DLL_API ROSEAttributesListCache
+   {
+     public:
+       // The list of comments, CPP directives and tokens of the file (as built by getPreprocessorDirectives()).  The list
+       // returned belongs to the caller; its PreprocessingInfo objects are copies (attaching them to the AST changes them)
+       // but its raw token stream is shared with every other list built from the same contents and must not be modified.
+          static ROSEAttributesList* getPreprocessorDirectives( const std::string & fileName );
+
+       // Forget the lists of the process (the token streams of the lists already returned stay valid).
+          static void clear();
+
+       // Number of files lexed, and of lists read from the cache directory, since the process started.
+          static size_t numberOfFilesLexed();
+          static size_t numberOfFilesLoaded();
+   };
+
 
 // #ifndef USE_ROSE
 #ifndef ROSE_SKIP_COMPILATION_OF_WAVE
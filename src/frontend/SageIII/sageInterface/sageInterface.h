@@ -7,6 +7,7 @@
 
 #include "rosePublicConfig.h" // for ROSE_BUILD_JAVA_LANGUAGE_SUPPORT
 #include "nodeQuery.h" //for querySubTree
+#include "nodeQueryIndex.h" //for the hooks keeping the index of querySubTree current
 
 #if 0   // FMZ(07/07/2010): the argument "nextErrorCode" should be call-by-reference
 SgFile* determineFileType ( std::vector<std::string> argv, int nextErrorCode, SgProject* project );
@@ -2084,6 +2085,7 @@ void setParameterList(actualFunction *func,SgFunctionParameterList *paralist) {
 
      func->set_parameterList(paralist);
      paralist->set_parent(func);
+     NodeQuery::QueryIndex::subtreeChanged(func);
 
      {
         // DQ (5/15/2012): Need to set the declptr in each SgInitializedName IR node.
@@ -15,6 +15,7 @@
 #include "FileUtility.h"
 #include "Replace.h"
 #include "omp_simd.h"
+#include "omp_lowering.h"
 
 #include "Outliner.hh"
 
@@ -31,6 +32,16 @@ const char *licenseText =
  *  Variable Definitions
  *---------------------------------------------------------------------------*/
 ROSE_DLL_API int Rose::Cmdline::verbose = 0;
+ROSE_DLL_API int Rose::Cmdline::Unparser::jobs = 1;
+ROSE_DLL_API bool Rose::Cmdline::Unparser::incrementalNameQualification = false;
+ROSE_DLL_API bool Rose::Cmdline::Unparser::patchOutput = false;
+ROSE_DLL_API int Rose::Cmdline::Frontend::jobs = 1;
+ROSE_DLL_API bool Rose::Cmdline::Frontend::production = false;
+ROSE_DLL_API bool Rose::Cmdline::Frontend::compactSourcePositions = false;
+ROSE_DLL_API bool Rose::Cmdline::Frontend::clangPreprocessingInfo = false;
+ROSE_DLL_API std::string Rose::Cmdline::Frontend::preprocessingInfoCache;
+ROSE_DLL_API std::string Rose::Cmdline::Frontend::clangPrecompiledHeaders;
+ROSE_DLL_API int Rose::Cmdline::Backend::jobs = 1;
 ROSE_DLL_API std::list<std::string> Rose::Cmdline::Fortran::Ofp::jvm_options;
 
 /*-----------------------------------------------------------------------------
@@ -361,6 +372,8 @@ CommandlineProcessing::isOptionTakingSecondParameter( string argument )
 
           // TOO1 (2/13/2014): Starting to refactor CLI handling into separate namespaces
           Rose::Cmdline::Unparser::OptionRequiresArgument(argument) ||
+          Rose::Cmdline::Frontend::OptionRequiresArgument(argument) ||
+          Rose::Cmdline::Backend::OptionRequiresArgument(argument) ||
           Rose::Cmdline::Fortran::OptionRequiresArgument(argument) ||
           //Rose::Cmdline::Java::OptionRequiresArgument(argument) ||
 
@@ -1080,6 +1093,8 @@ SgProject::processCommandLine(const vector<string>& input_argv)
         }
 
       Rose::Cmdline::Unparser::Process(this, local_commandLineArgumentList);
+      Rose::Cmdline::Frontend::Process(this, local_commandLineArgumentList);
+      Rose::Cmdline::Backend::Process(this, local_commandLineArgumentList);
       Rose::Cmdline::Fortran::Process(this, local_commandLineArgumentList);
       Rose::Cmdline::Gnu::Process(this, local_commandLineArgumentList);
 
@@ -1645,6 +1660,8 @@ Rose::Cmdline::
 StripRoseOptions (std::vector<std::string>& argv)
 {
   Cmdline::Unparser::StripRoseOptions(argv);
+  Cmdline::Frontend::StripRoseOptions(argv);
+  Cmdline::Backend::StripRoseOptions(argv);
   Cmdline::Fortran::StripRoseOptions(argv);
 }// Cmdline::StripRoseOptions
 
@@ -1692,7 +1709,8 @@ OptionRequiresArgument (const std::string& option)
 {
   return
       // ROSE Options
-      option == "-rose:unparser:some_option_taking_argument";
+      option == "-rose:unparser:some_option_taking_argument" ||
+      option == "-rose:unparser:jobs";
 }// ::Rose::Cmdline:Unparser:::OptionRequiresArgument
 
 void
@@ -1705,10 +1723,14 @@ StripRoseOptions (std::vector<std::string>& argv)
   // (1) Options WITHOUT an argument
   // Example: sla(argv, "-rose:", "($)", "(unparser)",1);
   sla(argv, "-rose:unparser:", "($)", "(clobber_input_file)",1);
+  sla(argv, Cmdline::Unparser::option_prefix, "($)", "(incremental_name_qualification)",1);
+  sla(argv, Cmdline::Unparser::option_prefix, "($)", "(patch_output)",1);
 
   //
   // (2) Options WITH an argument
   //
+  int integerOption = 0;
+  sla(argv, Cmdline::Unparser::option_prefix, "($)^", "(jobs)", &integerOption, 1);
 
   // Remove Unparser options with ROSE-unparser prefix; option arguments removed
   // by generateOptionWithNameParameterList.
@@ -1733,6 +1755,9 @@ Process (SgProject* project, std::vector<std::string>& argv)
       std::cout << "[INFO] Processing Unparser commandline options" << std::endl;
 
   ProcessClobberInputFile(project, argv);
+  ProcessJobs(project, argv);
+  ProcessIncrementalNameQualification(project, argv);
+  ProcessPatchOutput(project, argv);
 }// ::Rose::Cmdline::Unparser::Process
 
 void
@@ -1759,6 +1784,340 @@ ProcessClobberInputFile (SgProject* project, std::vector<std::string>& argv)
   }
 }// ::Rose::Cmdline::Unparser::ProcessClobberInputFile
 
+void
+Rose::Cmdline::Unparser::
+ProcessJobs (SgProject* project, std::vector<std::string>& argv)
+{
+  int integerOptionForJobs = 0;
+  bool has_jobs =
+      CommandlineProcessing::isOptionWithParameter(
+          argv,
+          Cmdline::Unparser::option_prefix,
+          "(jobs)",
+          integerOptionForJobs,
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_jobs)
+  {
+      if (integerOptionForJobs < 0)
+      {
+          std::cout
+              << "[FATAL] "
+              << "Invalid argument to -rose:unparser:jobs; expecting a non-negative integer"
+              << std::endl;
+          exit(1);
+      }
+
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:unparser:jobs " << integerOptionForJobs << "]" << std::endl;
+
+      Cmdline::Unparser::jobs = integerOptionForJobs;
+  }
+}// ::Rose::Cmdline::Unparser::ProcessJobs
+
+void
+Rose::Cmdline::Unparser::
+ProcessIncrementalNameQualification (SgProject* project, std::vector<std::string>& argv)
+{
+  bool has_incremental_name_qualification =
+      CommandlineProcessing::isOption(
+          argv,
+          Cmdline::Unparser::option_prefix,
+          "incremental_name_qualification",
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_incremental_name_qualification)
+  {
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:unparser:incremental_name_qualification]" << std::endl;
+
+      Cmdline::Unparser::incrementalNameQualification = true;
+  }
+}// ::Rose::Cmdline::Unparser::ProcessIncrementalNameQualification
+
+void
+Rose::Cmdline::Unparser::
+ProcessPatchOutput (SgProject* project, std::vector<std::string>& argv)
+{
+  bool has_patch_output =
+      CommandlineProcessing::isOption(
+          argv,
+          Cmdline::Unparser::option_prefix,
+          "patch_output",
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_patch_output)
+  {
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:unparser:patch_output]" << std::endl;
+
+      Cmdline::Unparser::patchOutput = true;
+  }
+}// ::Rose::Cmdline::Unparser::ProcessPatchOutput
+
+//------------------------------------------------------------------------------
+//                                  Frontend
+//------------------------------------------------------------------------------
+
+bool
+Rose::Cmdline::Frontend::
+OptionRequiresArgument (const std::string& option)
+{
+  return
+      // ROSE Options
+      option == "-rose:frontend:jobs" ||
+      option == "-rose:frontend:preprocessing_info_cache" ||
+      option == "-rose:frontend:clang_precompiled_headers";
+}// ::Rose::Cmdline::Frontend::OptionRequiresArgument
+
+void
+Rose::Cmdline::Frontend::
+StripRoseOptions (std::vector<std::string>& argv)
+{
+  // (1) Options WITHOUT an argument
+  sla(argv, Cmdline::Frontend::option_prefix, "($)", "(production)",1);
+  sla(argv, Cmdline::Frontend::option_prefix, "($)", "(compact_source_positions)",1);
+  sla(argv, Cmdline::Frontend::option_prefix, "($)", "(clang_preprocessing_info)",1);
+
+  // (2) Options WITH an argument
+  int integerOption = 0;
+  sla(argv, Cmdline::Frontend::option_prefix, "($)^", "(jobs)", &integerOption, 1);
+  std::string stringOption;
+  sla(argv, Cmdline::Frontend::option_prefix, "($)^", "(preprocessing_info_cache)", &stringOption, 1);
+  sla(argv, Cmdline::Frontend::option_prefix, "($)^", "(clang_precompiled_headers)", &stringOption, 1);
+}// ::Rose::Cmdline::Frontend::StripRoseOptions
+
+void
+Rose::Cmdline::Frontend::
+Process (SgProject* project, std::vector<std::string>& argv)
+{
+  if (SgProject::get_verbose() > 1)
+      std::cout << "[INFO] Processing Frontend commandline options" << std::endl;
+
+  ProcessJobs(project, argv);
+  ProcessProduction(project, argv);
+  ProcessCompactSourcePositions(project, argv);
+  ProcessClangPreprocessingInfo(project, argv);
+  ProcessPreprocessingInfoCache(project, argv);
+  ProcessClangPrecompiledHeaders(project, argv);
+}// ::Rose::Cmdline::Frontend::Process
+
+void
+Rose::Cmdline::Frontend::
+ProcessJobs (SgProject* project, std::vector<std::string>& argv)
+{
+  int integerOptionForJobs = 0;
+  bool has_jobs =
+      CommandlineProcessing::isOptionWithParameter(
+          argv,
+          Cmdline::Frontend::option_prefix,
+          "(jobs)",
+          integerOptionForJobs,
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_jobs)
+  {
+      if (integerOptionForJobs < 0)
+      {
+          std::cout
+              << "[FATAL] "
+              << "Invalid argument to -rose:frontend:jobs; expecting a non-negative integer"
+              << std::endl;
+          exit(1);
+      }
+
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:frontend:jobs " << integerOptionForJobs << "]" << std::endl;
+
+      Cmdline::Frontend::jobs = integerOptionForJobs;
+  }
+}// ::Rose::Cmdline::Frontend::ProcessJobs
+
+void
+Rose::Cmdline::Frontend::
+ProcessProduction (SgProject* project, std::vector<std::string>& argv)
+{
+  bool has_production =
+      CommandlineProcessing::isOption(
+          argv,
+          Cmdline::Frontend::option_prefix,
+          "production",
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_production)
+  {
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:frontend:production]" << std::endl;
+
+      Cmdline::Frontend::production = true;
+  }
+}// ::Rose::Cmdline::Frontend::ProcessProduction
+
+void
+Rose::Cmdline::Frontend::
+ProcessCompactSourcePositions (SgProject* project, std::vector<std::string>& argv)
+{
+  bool has_compact_source_positions =
+      CommandlineProcessing::isOption(
+          argv,
+          Cmdline::Frontend::option_prefix,
+          "compact_source_positions",
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_compact_source_positions)
+  {
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:frontend:compact_source_positions]" << std::endl;
+
+      Cmdline::Frontend::compactSourcePositions = true;
+  }
+}// ::Rose::Cmdline::Frontend::ProcessCompactSourcePositions
+
+void
+Rose::Cmdline::Frontend::
+ProcessClangPreprocessingInfo (SgProject* project, std::vector<std::string>& argv)
+{
+  bool has_clang_preprocessing_info =
+      CommandlineProcessing::isOption(
+          argv,
+          Cmdline::Frontend::option_prefix,
+          "clang_preprocessing_info",
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_clang_preprocessing_info)
+  {
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:frontend:clang_preprocessing_info]" << std::endl;
+
+      Cmdline::Frontend::clangPreprocessingInfo = true;
+  }
+}// ::Rose::Cmdline::Frontend::ProcessClangPreprocessingInfo
+
+void
+Rose::Cmdline::Frontend::
+ProcessPreprocessingInfoCache (SgProject* project, std::vector<std::string>& argv)
+{
+  std::string directory;
+  bool has_preprocessing_info_cache =
+      CommandlineProcessing::isOptionWithParameter(
+          argv,
+          Cmdline::Frontend::option_prefix,
+          "(preprocessing_info_cache)",
+          directory,
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_preprocessing_info_cache)
+  {
+      if (directory.empty())
+      {
+          std::cout
+              << "[FATAL] "
+              << "Invalid argument to -rose:frontend:preprocessing_info_cache; expecting a directory"
+              << std::endl;
+          exit(1);
+      }
+
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:frontend:preprocessing_info_cache " << directory << "]" << std::endl;
+
+      Cmdline::Frontend::preprocessingInfoCache = directory;
+  }
+}// ::Rose::Cmdline::Frontend::ProcessPreprocessingInfoCache
+
+void
+Rose::Cmdline::Frontend::
+ProcessClangPrecompiledHeaders (SgProject* project, std::vector<std::string>& argv)
+{
+  std::string directory;
+  bool has_clang_precompiled_headers =
+      CommandlineProcessing::isOptionWithParameter(
+          argv,
+          Cmdline::Frontend::option_prefix,
+          "(clang_precompiled_headers)",
+          directory,
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_clang_precompiled_headers)
+  {
+      if (directory.empty())
+      {
+          std::cout
+              << "[FATAL] "
+              << "Invalid argument to -rose:frontend:clang_precompiled_headers; expecting a directory"
+              << std::endl;
+          exit(1);
+      }
+
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:frontend:clang_precompiled_headers " << directory << "]" << std::endl;
+
+      Cmdline::Frontend::clangPrecompiledHeaders = directory;
+  }
+}// ::Rose::Cmdline::Frontend::ProcessClangPrecompiledHeaders
+
+//------------------------------------------------------------------------------
+//                                  Backend
+//------------------------------------------------------------------------------
+
+bool
+Rose::Cmdline::Backend::
+OptionRequiresArgument (const std::string& option)
+{
+  return
+      // ROSE Options
+      option == "-rose:backend:jobs";
+}// ::Rose::Cmdline::Backend::OptionRequiresArgument
+
+void
+Rose::Cmdline::Backend::
+StripRoseOptions (std::vector<std::string>& argv)
+{
+  // (2) Options WITH an argument
+  int integerOption = 0;
+  sla(argv, Cmdline::Backend::option_prefix, "($)^", "(jobs)", &integerOption, 1);
+}// ::Rose::Cmdline::Backend::StripRoseOptions
+
+void
+Rose::Cmdline::Backend::
+Process (SgProject* project, std::vector<std::string>& argv)
+{
+  if (SgProject::get_verbose() > 1)
+      std::cout << "[INFO] Processing Backend commandline options" << std::endl;
+
+  ProcessJobs(project, argv);
+}// ::Rose::Cmdline::Backend::Process
+
+void
+Rose::Cmdline::Backend::
+ProcessJobs (SgProject* project, std::vector<std::string>& argv)
+{
+  int integerOptionForJobs = 0;
+  bool has_jobs =
+      CommandlineProcessing::isOptionWithParameter(
+          argv,
+          Cmdline::Backend::option_prefix,
+          "(jobs)",
+          integerOptionForJobs,
+          Cmdline::REMOVE_OPTION_FROM_ARGV);
+
+  if (has_jobs)
+  {
+      if (integerOptionForJobs < 0)
+      {
+          std::cout
+              << "[FATAL] "
+              << "Invalid argument to -rose:backend:jobs; expecting a non-negative integer"
+              << std::endl;
+          exit(1);
+      }
+
+      if (SgProject::get_verbose() >= 1)
+          std::cout << "[INFO] [Cmdline] [-rose:backend:jobs " << integerOptionForJobs << "]" << std::endl;
+
+      Cmdline::Backend::jobs = integerOptionForJobs;
+  }
+}// ::Rose::Cmdline::Backend::ProcessJobs
+
 //------------------------------------------------------------------------------
 //                                  Fortran
 //------------------------------------------------------------------------------
@@ -2079,6 +2438,41 @@ SgFile::usage ()
 "                             try to compile as much as possible, ignoring failures,\n"
 "                             in order to gauage the overall status of your translator,\n"
 "                             with respect to that application.\n"
+"     -rose:frontend:jobs N\n"
+"                             parse the C/C++ input files with Clang using N\n"
+"                             worker threads (0 = one per hardware thread);\n"
+"                             translation to the ROSE AST stays serial and in\n"
+"                             command-line order, so the AST is unchanged\n"
+"     -rose:frontend:production\n"
+"                             skip the passes of the AST post-processing that\n"
+"                             only verify the AST built by the frontend\n"
+"     -rose:frontend:compact_source_positions\n"
+"                             store the start and end source positions of the\n"
+"                             AST nodes in 64 bit encodings instead of Sg_File_Info\n"
+"                             objects; these are rebuilt when they are asked for\n"
+"     -rose:frontend:clang_preprocessing_info\n"
+"                             record the comments, CPP directives and tokens of\n"
+"                             the C/C++ input files while Clang preprocesses them\n"
+"                             instead of lexing the files a second time\n"
+"     -rose:frontend:preprocessing_info_cache DIR\n"
+"                             keep the comments, CPP directives and tokens of\n"
+"                             the header files in DIR, keyed by the hash of the\n"
+"                             file contents, so that later runs do not lex the\n"
+"                             headers again (headers are always lexed only once\n"
+"                             per process)\n"
+"     -rose:frontend:clang_precompiled_headers DIR\n"
+"                             precompile the #include lines at the start of\n"
+"                             each C/C++ input file with Clang and keep the\n"
+"                             precompiled headers in DIR, keyed by the hash of\n"
+"                             the headers and of the compiler options, so that\n"
+"                             files and runs with the same includes parse them\n"
+"                             only once\n"
+"     -rose:backend:jobs N\n"
+"                             compile the generated files with up to N backend\n"
+"                             compiler processes at a time (0 = one per hardware\n"
+"                             thread), taking GNU make jobserver tokens when run\n"
+"                             by make -j; their output is written in command-line\n"
+"                             order and linking starts once all files are compiled\n"
 "\n"
 "Operation modifiers:\n"
 "     -rose:output_warnings   compile with warnings mode on\n"
@@ -2106,6 +2500,10 @@ SgFile::usage ()
 "     -rose:OpenMP:lowering, -rose:openmp:lowering\n"
 "                             on top of -rose:openmp:ast_only, transform AST with OpenMP nodes into multithreaded code \n"
 "                             targeting GCC GOMP runtime library\n"
+"     -rose:OpenMP:inline_static_schedule, -rose:openmp:inline_static_schedule\n"
+"                             with -rose:openmp:lowering, schedule omp for loops with a static schedule\n"
+"                             (without chunk size and ordered clause) in the generated code from\n"
+"                             omp_get_thread_num() and omp_get_num_threads(), without runtime calls\n"
 "     -rose:fortran\n"
 "                             compile Fortran code, determining version of\n"
 "                             Fortran from file suffix)\n"
@@ -2279,6 +2677,20 @@ SgFile::usage ()
 "                               that with this option you use ROSE, and run your build\n"
 "                               system, sequentially.\n"
 "                               **CAUTION**RED*ALERT**CAUTION**\n"
+"     -rose:unparser:jobs N\n"
+"                               generate the C/C++ source files using N worker\n"
+"                               threads (0 = one per hardware thread); the files\n"
+"                               are written in order and are byte-identical to\n"
+"                               the output of the serial unparser\n"
+"     -rose:unparser:incremental_name_qualification\n"
+"                               when a file is unparsed again, only requalify the\n"
+"                               names in the function definitions changed since\n"
+"                               (other changes requalify the whole file)\n"
+"     -rose:unparser:patch_output\n"
+"                               with -rose:unparse_tokens, write each file as the\n"
+"                               original file with only the changed statements\n"
+"                               regenerated (files changed at the global scope\n"
+"                               are unparsed as a whole)\n"
 "     -rose:unparse_line_directives\n"
 "                               unparse statements using #line directives with\n"
 "                               reference to the original file and line number\n"
@@ -3486,6 +3898,18 @@ SgFile::processRoseCommandLineOptions ( vector<string> & argv )
        }
      }
      
+     // schedule static omp for loops in the generated code instead of calling the runtime
+     if ( CommandlineProcessing::isOption(argv,"-rose:OpenMP:","inline_static_schedule",true) == true
+         ||CommandlineProcessing::isOption(argv,"-rose:openmp:","inline_static_schedule",true) == true
+         ||CommandlineProcessing::isOption(argv,"--rose:openmp:","inline_static_schedule",true) == true
+         ||CommandlineProcessing::isOption(argv,"--rose:OpenMP:","inline_static_schedule",true) == true
+         )
+     {
+       if ( SgProject::get_verbose() >= 1 )
+         printf ("OpenMP sub option for inline static loop scheduling specified \n");
+       OmpSupport::inline_static_schedule = true;
+     }
+
      // Patrick, 9/22/2022
      if (CommandlineProcessing::isOption(argv, "-rose:simd:", "(intel-avx)", true) == true) {
         simd_arch = Intel_AVX512;    
@@ -4140,6 +4564,8 @@ SgFile::stripRoseCommandLineOptions ( vector<string> & argv )
      optionCount = sla(argv, "--rose:", "($)", "(openmp:ast_only|OpenMP:ast_only)",1);
      optionCount = sla(argv, "--rose:", "($)", "(openmp:lowering|OpenMP:lowering)",1);
      optionCount = sla(argv, "--rose:", "($)", "(openmp:analyzing|OpenMP:analyzing)",1);
+     optionCount = sla(argv, "-rose:", "($)", "(openmp:inline_static_schedule|OpenMP:inline_static_schedule)",1);
+     optionCount = sla(argv, "--rose:", "($)", "(openmp:inline_static_schedule|OpenMP:inline_static_schedule)",1);
 
      optionCount = sla(argv, "-rose:", "($)", "(C89|C89_only)",1);
      optionCount = sla(argv, "-rose:", "($)", "(C99|C99_only)",1);
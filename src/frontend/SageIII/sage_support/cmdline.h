@@ -70,6 +70,29 @@ namespace Cmdline {
   namespace Unparser {
     static const std::string option_prefix = "-rose:unparser:";
 
+    /** Number of worker threads used by the backend to generate the source
+     *  code of a project concurrently (-rose:unparser:jobs N).
+     *
+     *  The default (1) selects the serial unparser; 0 selects one worker
+     *  per hardware thread.
+     */
+    extern ROSE_DLL_API int jobs;
+
+    /** Requalify only the function definitions changed since the previous
+     *  name qualification of a file (-rose:unparser:incremental_name_qualification).
+     *
+     *  Files changed outside of function definitions are requalified as a whole.
+     */
+    extern ROSE_DLL_API bool incrementalNameQualification;
+
+    /** Write the files unparsed with the token-based unparsing as the
+     *  original file with only the changed statements regenerated
+     *  (-rose:unparser:patch_output).
+     *
+     *  Files that cannot be written this way are unparsed as a whole.
+     */
+    extern ROSE_DLL_API bool patchOutput;
+
     /** @returns true if the Unparser option requires a user-specified argument.
      */
     bool
@@ -85,8 +108,141 @@ namespace Cmdline {
 
     void
     ProcessClobberInputFile (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:unparser:jobs
+    void
+    ProcessJobs (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:unparser:incremental_name_qualification
+    void
+    ProcessIncrementalNameQualification (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:unparser:patch_output
+    void
+    ProcessPatchOutput (SgProject* project, std::vector<std::string>& argv);
   } // namespace ::Rose::Cmdline::Unparser
 
+  namespace Frontend {
+    static const std::string option_prefix = "-rose:frontend:";
+
+    /** Number of worker threads used by the frontend to parse the C/C++
+     *  input files of a project with Clang concurrently (-rose:frontend:jobs N).
+     *
+     *  Only the Clang parse runs on the workers: the translation of each
+     *  Clang AST to Sage III (and the rest of SgFile::runFrontend()) stays
+     *  serial and in command-line order, so the AST is the same as with the
+     *  serial frontend.  The default (1) selects the serial frontend; 0
+     *  selects one worker per hardware thread.
+     */
+    extern ROSE_DLL_API int jobs;
+
+    /** Skip the verification-only passes of the AST post-processing
+     *  (-rose:frontend:production).
+     *
+     *  The passes that fix up the AST are always run.
+     */
+    extern ROSE_DLL_API bool production;
+
+    /** Store the source positions of the AST in compact form after the
+     *  frontend (-rose:frontend:compact_source_positions).
+     *
+     *  See SgLocatedNode::compactSourcePositions().
+     */
+    extern ROSE_DLL_API bool compactSourcePositions;
+
+    /** Record the comments, CPP directives and token stream of the C/C++ input
+     *  files while Clang preprocesses them instead of lexing the files again
+     *  when they are attached to the AST (-rose:frontend:clang_preprocessing_info).
+     */
+    extern ROSE_DLL_API bool clangPreprocessingInfo;
+
+    /** Directory where the comments, CPP directives and tokens of the header
+     *  files are kept between runs, keyed by the hash of the file contents
+     *  (-rose:frontend:preprocessing_info_cache DIR).
+     *
+     *  Empty (the default) keeps them only for the lifetime of the process.
+     *  See ROSEAttributesListCache.
+     */
+    extern ROSE_DLL_API std::string preprocessingInfoCache;
+
+    /** Directory where Clang precompiled headers of the #include lines at
+     *  the start of the C/C++ input files are kept, keyed by the hash of the
+     *  included text and of the compiler options
+     *  (-rose:frontend:clang_precompiled_headers DIR).
+     *
+     *  Empty (the default) parses the headers of each file again.
+     */
+    extern ROSE_DLL_API std::string clangPrecompiledHeaders;
+
+    /** @returns true if the Frontend option requires a user-specified argument.
+     */
+    bool
+    OptionRequiresArgument (const std::string& option);
+
+    void
+    StripRoseOptions (std::vector<std::string>& argv);
+
+    /** Process all Frontend-specific commandline options, i.e. -rose:frontend.
+     */
+    void
+    Process (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:frontend:jobs
+    void
+    ProcessJobs (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:frontend:production
+    void
+    ProcessProduction (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:frontend:compact_source_positions
+    void
+    ProcessCompactSourcePositions (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:frontend:clang_preprocessing_info
+    void
+    ProcessClangPreprocessingInfo (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:frontend:preprocessing_info_cache
+    void
+    ProcessPreprocessingInfoCache (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:frontend:clang_precompiled_headers
+    void
+    ProcessClangPrecompiledHeaders (SgProject* project, std::vector<std::string>& argv);
+  } // namespace ::Rose::Cmdline::Frontend
+
+  namespace Backend {
+    static const std::string option_prefix = "-rose:backend:";
+
+    /** Number of backend compiler processes run concurrently to compile the
+     *  generated files of a project (-rose:backend:jobs N).
+     *
+     *  The default (1) compiles the files one after another; 0 selects one
+     *  process per hardware thread.  When run by GNU make with a jobserver
+     *  (MAKEFLAGS), each process beyond the first also takes a jobserver token.
+     *  The link step starts once all of the files are compiled.
+     */
+    extern ROSE_DLL_API int jobs;
+
+    /** @returns true if the Backend option requires a user-specified argument.
+     */
+    bool
+    OptionRequiresArgument (const std::string& option);
+
+    void
+    StripRoseOptions (std::vector<std::string>& argv);
+
+    /** Process all Backend-specific commandline options, i.e. -rose:backend.
+     */
+    void
+    Process (SgProject* project, std::vector<std::string>& argv);
+
+    // -rose:backend:jobs
+    void
+    ProcessJobs (SgProject* project, std::vector<std::string>& argv);
+  } // namespace ::Rose::Cmdline::Backend
+
   namespace Fortran {
     static const std::string option_prefix = "-rose:fortran:";
 
@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <thread>
 
 // DQ (12/22/2019): I don't need this now, and it is an issue for some compilers (e.g. GNU 4.9.4).
 // DQ (12/21/2019): Require hash table support for determining the shared nodes in the ASTs.
@@ -1288,6 +1289,12 @@ namespace Ofp {
 }// Rose
 #endif
 
+#ifdef ROSE_BUILD_CXX_LANGUAGE_SUPPORT
+// Clang frontend support for Rose::Frontend::RunParallel() (see clang-frontend.hpp)
+void clang_preparse(const std::vector<std::pair<SgSourceFile*, std::vector<std::string> > > & files, int jobs);
+void clang_preparse_finish();
+#endif
+
 // The "purpose" as it appears in the man page, uncapitalized and a single, short, line.
 static const char *purpose = "This tool provided basic ROSE source-to-source functionality";
 
@@ -2165,6 +2172,19 @@ SgProject::parse()
   // warnings from EDG processing are OK but not errors
      ROSE_ASSERT (errorCode <= 3);
 
+  // Replace the Sg_File_Info objects of the AST by compact source positions (-rose:frontend:compact_source_positions),
+  // after the comments and CPP directives are attached (which is the last use of the source positions in the frontend).
+     if (Rose::Cmdline::Frontend::compactSourcePositions == true)
+        {
+          TimingPerformance timer ("AST compact source positions:");
+
+          size_t numberOfCompactSourcePositions = SgLocatedNode::compactSourcePositions();
+          if ( SgProject::get_verbose() >= 1 )
+             {
+               printf ("Stored %zu source positions in compact form \n",numberOfCompactSourcePositions);
+             }
+        }
+
   // if (get_useBackendOnly() == false)
      if ( SgProject::get_verbose() >= 1 )
         {
@@ -2361,34 +2381,26 @@ SgFile::generate_C_preprocessor_intermediate_filename( string sourceFilename )
 int openFortranParser_main(int argc, char **argv );
 #endif
 
-int
-SgFile::callFrontEnd()
+// Command lines built ahead of SgFile::callFrontEnd() by Rose::Frontend::RunParallel()
+struct PreparedFrontendCommandLine
    {
-     if (SgProject::get_verbose() > 0)
-        {
-          std::cout << "[INFO] [SgFile::callFrontEnd]" << std::endl;
-        }
-
-  // DQ (1/17/2006): test this
-  // ROSE_ASSERT(get_fileInfo() != NULL);
-
-     int fileNameIndex = 0;
-
-  // DQ (4/21/2006): I think we can now assert this!
-     ROSE_ASSERT(fileNameIndex == 0);
-
-  // DQ (7/6/2005): Introduce tracking of performance of ROSE.
-     TimingPerformance timer ("AST Front End Processing (SgFile):");
+     vector<string> argv;
+     vector<string> inputCommandLine;
+   };
 
-  // This function processes the command line and calls the EDG frontend.
-     int frontendErrorLevel = 0;
+static std::map<SgFile*,PreparedFrontendCommandLine> preparedFrontendCommandLines;
 
+// Process the ROSE specific options of the file's commandline (into localCopy_argv) and build the commandline passed to
+// the frontend (into inputCommandLine). Factored out of SgFile::callFrontEnd() so that it can be done ahead of time.
+static void
+buildFrontendCommandLine ( SgFile* file, int fileNameIndex, vector<string> & localCopy_argv, vector<string> & inputCommandLine )
+   {
   // Build an argc,argv based C style commandline (we might not really need this)
-     vector<string> argv = get_originalCommandLineArgumentList();
+     vector<string> argv = file->get_originalCommandLineArgumentList();
 
 #if 0
-     printf ("get_C_only()   = %s \n",get_C_only() ? "true" : "false");
-     printf ("get_Cxx_only() = %s \n",get_Cxx_only() ? "true" : "false");
+     printf ("get_C_only()   = %s \n",file->get_C_only() ? "true" : "false");
+     printf ("get_Cxx_only() = %s \n",file->get_Cxx_only() ? "true" : "false");
 #endif
 
 #if ROSE_INTERNAL_DEBUG
@@ -2410,14 +2422,14 @@ SgFile::callFrontEnd()
 #if 0
      printf ("translatorCommandLineString = %s \n",translatorCommandLineString.c_str());
 #endif
-     set_savedFrontendCommandLine(translatorCommandLineString);
+     file->set_savedFrontendCommandLine(translatorCommandLineString);
 
   // display("At TOP of SgFile::callFrontEnd()");
 
   // local copies of argc and argv variables
   // The purpose of building local copies is to avoid
   // the modification of the command line by SLA
-     vector<string> localCopy_argv = argv;
+     localCopy_argv = argv;
   // printf ("DONE with copy of command line! \n");
 #if 0
      std::string tmp2_translatorCommandLineString = CommandlineProcessing::generateStringFromArgList(localCopy_argv,false,true);
@@ -2425,17 +2437,17 @@ SgFile::callFrontEnd()
 #endif
   // Process command line options specific to ROSE
   // This leaves all filenames and non-rose specific option in the argv list
-     processRoseCommandLineOptions (localCopy_argv);
+     file->processRoseCommandLineOptions (localCopy_argv);
 #if 0
-     printf ("After processRoseCommandLineOptions(): get_C_only()   = %s \n",get_C_only() ? "true" : "false");
-     printf ("After processRoseCommandLineOptions(): get_Cxx_only() = %s \n",get_Cxx_only() ? "true" : "false");
+     printf ("After processRoseCommandLineOptions(): get_C_only()   = %s \n",file->get_C_only() ? "true" : "false");
+     printf ("After processRoseCommandLineOptions(): get_Cxx_only() = %s \n",file->get_Cxx_only() ? "true" : "false");
 #endif
   // DQ (6/21/2005): Process template specific options so that we can generated
   // code for the backend compiler (this processing is backend specific).
-     processBackendSpecificCommandLineOptions (localCopy_argv);
+     file->processBackendSpecificCommandLineOptions (localCopy_argv);
 #if 0
-     printf ("After processBackendSpecificCommandLineOptions(): get_C_only()   = %s \n",get_C_only() ? "true" : "false");
-     printf ("After processBackendSpecificCommandLineOptions(): get_Cxx_only() = %s \n",get_Cxx_only() ? "true" : "false");
+     printf ("After processBackendSpecificCommandLineOptions(): get_C_only()   = %s \n",file->get_C_only() ? "true" : "false");
+     printf ("After processBackendSpecificCommandLineOptions(): get_Cxx_only() = %s \n",file->get_Cxx_only() ? "true" : "false");
 #endif
 #if 0
      std::string tmp4_translatorCommandLineString = CommandlineProcessing::generateStringFromArgList(localCopy_argv,false,true);
@@ -2447,21 +2459,20 @@ SgFile::callFrontEnd()
   // int numberOfCommandLineArguments = 24;
   // char** inputCommandLine = new char* [numberOfCommandLineArguments];
   // ROSE_ASSERT (inputCommandLine != NULL);
-     vector<string> inputCommandLine;
 
 #if 0
      printf ("Inside of SgFile::callFrontEnd(): Calling build_EDG_CommandLine (fileNameIndex = %d) \n",fileNameIndex);
 #endif
 
   // Build the commandline for EDG
-     if (get_C_only() || get_Cxx_only() || get_Cuda_only() || get_OpenCL_only() )
+     if (file->get_C_only() || file->get_Cxx_only() || file->get_Cuda_only() || file->get_OpenCL_only() )
         {
 #ifdef BACKEND_CXX_IS_CLANG_COMPILER
      // REX: Clang backend is now supported with Clang frontend
 #endif
 
        // REX: Call Clang command line builder (EDG removed)
-          build_CLANG_CommandLine (inputCommandLine,localCopy_argv,fileNameIndex );
+          file->build_CLANG_CommandLine (inputCommandLine,localCopy_argv,fileNameIndex );
         }
        else
         {
@@ -2473,6 +2484,47 @@ SgFile::callFrontEnd()
 #if 0
      printf ("DONE: Inside of SgFile::callFrontEnd(): Calling build_EDG_CommandLine (fileNameIndex = %d) \n",fileNameIndex);
 #endif
+   }
+
+int
+SgFile::callFrontEnd()
+   {
+     if (SgProject::get_verbose() > 0)
+        {
+          std::cout << "[INFO] [SgFile::callFrontEnd]" << std::endl;
+        }
+
+  // DQ (1/17/2006): test this
+  // ROSE_ASSERT(get_fileInfo() != NULL);
+
+     int fileNameIndex = 0;
+
+  // DQ (4/21/2006): I think we can now assert this!
+     ROSE_ASSERT(fileNameIndex == 0);
+
+  // DQ (7/6/2005): Introduce tracking of performance of ROSE.
+     TimingPerformance timer ("AST Front End Processing (SgFile):");
+
+  // This function processes the command line and calls the EDG frontend.
+     int frontendErrorLevel = 0;
+
+  // Local copy of the commandline with the ROSE specific options processed, and the commandline for the frontend.
+  // Rose::Frontend::RunParallel() may have already built both (so that it could hand them to Clang ahead of time).
+     vector<string> localCopy_argv;
+     vector<string> inputCommandLine;
+
+     std::map<SgFile*,PreparedFrontendCommandLine>::iterator prepared = preparedFrontendCommandLines.find(this);
+     if (prepared != preparedFrontendCommandLines.end())
+        {
+          localCopy_argv.swap(prepared->second.argv);
+          inputCommandLine.swap(prepared->second.inputCommandLine);
+          preparedFrontendCommandLines.erase(prepared);
+        }
+       else
+        {
+          buildFrontendCommandLine(this,fileNameIndex,localCopy_argv,inputCommandLine);
+        }
+
      std::string tmp_translatorCommandLineString = CommandlineProcessing::generateStringFromArgList(inputCommandLine,false,true);
 #if 0
      printf ("tmp_translatorCommandLineString = %s \n",tmp_translatorCommandLineString.c_str());
@@ -4400,7 +4452,14 @@ Rose::Frontend::Run(SgProject* project)
 
   int status = 0;
   {
-      status = Rose::Frontend::RunSerial(project);
+      if (Rose::Cmdline::Frontend::jobs != 1 && project->get_fileList().size() > 1)
+      {
+          status = Rose::Frontend::RunParallel(project);
+      }
+      else
+      {
+          status = Rose::Frontend::RunSerial(project);
+      }
 
       project->set_frontendErrorCode(status);
   }
@@ -4408,6 +4467,67 @@ Rose::Frontend::Run(SgProject* project)
   return status;
 } // Rose::Frontend::Run
 
+int
+Rose::Frontend::RunParallel(SgProject* project)
+{
+  int jobs = Rose::Cmdline::Frontend::jobs;
+  if (jobs <= 0)
+      jobs = std::max(1u, std::thread::hardware_concurrency());
+
+  if (SgProject::get_verbose() > 0)
+      std::cout << "[INFO] [Frontend] Running in parallel mode (" << jobs << " jobs)" << std::endl;
+
+#ifdef ROSE_BUILD_CXX_LANGUAGE_SUPPORT
+  // Only the Clang parse of each C/C++ file runs on the workers: it does not touch the ROSE AST, the memory pools, or
+  // any other ROSE state. The translation of each Clang AST into Sage III, and everything else done by
+  // SgFile::runFrontend(), is still done by RunSerial() on this thread and in command-line order, so the
+  // resulting AST (including the order of the memory pools and of the file ids) is the same as in serial mode.
+  std::vector<std::pair<SgSourceFile*, std::vector<std::string> > > clang_files;
+
+  std::vector<SgFile*> all_files = project->get_fileList();
+  for (SgFile* file : all_files)
+  {
+      ASSERT_not_null(file);
+      SgSourceFile* source_file = isSgSourceFile(file);
+      if (source_file == nullptr || source_file->get_skip_parser() == true)
+          continue;
+      if (!(source_file->get_C_only() || source_file->get_Cxx_only() || source_file->get_Cuda_only() || source_file->get_OpenCL_only()))
+          continue;
+      if (source_file->get_clang_il_to_graphviz() == true)
+          continue;
+
+      PreparedFrontendCommandLine & prepared = preparedFrontendCommandLines[file];
+      buildFrontendCommandLine(file, 0, prepared.argv, prepared.inputCommandLine);
+
+      if (source_file->get_useBackendOnly() == true || source_file->get_disable_edg_backend() == true || source_file->get_new_frontend() == true)
+          continue;
+
+      clang_files.push_back(std::make_pair(source_file, prepared.inputCommandLine));
+  }
+
+  clang_preparse(clang_files, jobs);
+
+  int status = 0;
+  try
+  {
+      status = Rose::Frontend::RunSerial(project);
+  }
+  catch (...)
+  {
+      clang_preparse_finish();
+      preparedFrontendCommandLines.clear();
+      throw;
+  }
+
+  clang_preparse_finish();
+  preparedFrontendCommandLines.clear();
+
+  return status;
+#else
+  return Rose::Frontend::RunSerial(project);
+#endif
+} // Rose::Frontend::RunParallel
+
 int
 Rose::Frontend::RunSerial(SgProject* project)
 {
@@ -4810,6 +4930,65 @@ SgSourceFile::buildAST( vector<string> argv, vector<string> inputCommandLine )
      return frontendErrorLevel;
    }
 
+// Backend compiles collected by SgProject::compileOutput() to run them concurrently (-rose:backend:jobs).  While this
+// is set, SgFile::compileOutput() only builds the command line of the backend compiler for the file and adds it here.
+struct DeferredBackendCompile
+   {
+     SgFile* file;
+     vector<string> commandLine;
+   };
+
+static vector<DeferredBackendCompile>* deferredBackendCompiles = NULL;
+
+// The exit status of SgFile::compileOutput() for the status of the backend compiler.
+static int
+compileOutputExitStatus ( SgFile* file, int returnValueForRose, int returnValueForCompiler )
+   {
+  // DQ (7/20/2006): Catch errors returned from unix "system" function
+  // (commonly "out of memory" errors, suggested by Peter and Jeremiah).
+     if (returnValueForCompiler < 0)
+        {
+          perror("Serious Error returned from internal systemFromVector command");
+        }
+
+  // Assemble an exit status that combines the values for ROSE and the C++/C compiler
+  // return an exit status which is the boolean OR of the bits from the EDG/SAGE/ROSE and the compile step
+     int finalCompiledExitStatus = returnValueForRose | returnValueForCompiler;
+
+  // It is a strange property of the UNIX $status that it does not map uniformally from
+  // the return value of the "exit" command (or "return" statement).  So if the exit
+  // status from the compilation stage is nonzero then we just make the exit status 1
+  // (this does seem to be a portable solution).
+  // FYI: only the first 8 bits of the exit value are significant (Solaris uses 'exit_value mod 256').
+     if (finalCompiledExitStatus != 0)
+        {
+       // If this it is non-zero then make it 1 to be more clear to external tools (e.g. make)
+          finalCompiledExitStatus = 1;
+        }
+
+  // DQ (9/19/2006): We need to invert the test result (return code) for
+  // negative tests (where failure is expected and success is an error).
+     if (file->get_negative_test() == true)
+        {
+          if ( file->get_verbose() > 1 )
+               printf ("This is a negative tests, so an error in compilation is a PASS and successful compilation is a FAIL (vendor compiler return value = %d) \n",returnValueForCompiler);
+
+          finalCompiledExitStatus = (finalCompiledExitStatus == 0) ? /* error */ 1 : /* success */ 0;
+        }
+
+#if 0
+     printf ("Program Terminated Normally (exit status = %d)! \n\n\n\n",finalCompiledExitStatus);
+#endif
+
+  // Liao, 4/26/2017. KeepGoingTranslator should keep going no mater what.
+     if (Rose::KeepGoing::g_keep_going)
+        {
+          finalCompiledExitStatus = 0;
+        }
+
+     return finalCompiledExitStatus;
+   }
+
 // DQ (10/14/2010): Removing reference to macros defined in rose_config.h (defined in the header file as a default parameter).
 // int SgFile::compileOutput ( vector<string>& argv, int fileNameIndex, const string& compilerNameOrig )
 int
@@ -5114,6 +5293,14 @@ SgFile::compileOutput ( vector<string>& argv, int fileNameIndex )
           printf ("In SgFile::compileOutput(): Calling systemFromVector(): compilerCmdLine = \n%s\n",CommandlineProcessing::generateStringFromArgList(compilerCmdLine,false,false).c_str());
 #endif
 
+       // The backend compiler is run later, together with those of the other files of the project.
+          if (deferredBackendCompiles != NULL)
+             {
+               DeferredBackendCompile deferredBackendCompile = { this, compilerCmdLine };
+               deferredBackendCompiles->push_back(deferredBackendCompile);
+               return 0;
+             }
+
        // DQ (2/20/2013): The timer used in TimingPerformance is now fixed to properly record elapsed wall clock time.
        // CAVE3 double check that is correct and shouldn't be compilerCmdLine
           returnValueForCompiler = systemFromVector (compilerCmdLine);
@@ -5167,49 +5354,7 @@ SgFile::compileOutput ( vector<string>& argv, int fileNameIndex )
                printf ("COMPILER NOT CALLED: compilerNameString = %s \n", "<unknown>" /* compilerNameString.c_str() */);
         }
 
-  // DQ (7/20/2006): Catch errors returned from unix "system" function
-  // (commonly "out of memory" errors, suggested by Peter and Jeremiah).
-     if (returnValueForCompiler < 0)
-        {
-          perror("Serious Error returned from internal systemFromVector command");
-        }
-
-  // Assemble an exit status that combines the values for ROSE and the C++/C compiler
-  // return an exit status which is the boolean OR of the bits from the EDG/SAGE/ROSE and the compile step
-     int finalCompiledExitStatus = returnValueForRose | returnValueForCompiler;
-
-  // It is a strange property of the UNIX $status that it does not map uniformally from
-  // the return value of the "exit" command (or "return" statement).  So if the exit
-  // status from the compilation stage is nonzero then we just make the exit status 1
-  // (this does seem to be a portable solution).
-  // FYI: only the first 8 bits of the exit value are significant (Solaris uses 'exit_value mod 256').
-     if (finalCompiledExitStatus != 0)
-        {
-       // If this it is non-zero then make it 1 to be more clear to external tools (e.g. make)
-          finalCompiledExitStatus = 1;
-        }
-
-  // DQ (9/19/2006): We need to invert the test result (return code) for
-  // negative tests (where failure is expected and success is an error).
-     if (get_negative_test() == true)
-        {
-          if ( get_verbose() > 1 )
-               printf ("This is a negative tests, so an error in compilation is a PASS and successful compilation is a FAIL (vendor compiler return value = %d) \n",returnValueForCompiler);
-
-          finalCompiledExitStatus = (finalCompiledExitStatus == 0) ? /* error */ 1 : /* success */ 0;
-        }
-
-#if 0
-     printf ("Program Terminated Normally (exit status = %d)! \n\n\n\n",finalCompiledExitStatus);
-#endif
-
-  // Liao, 4/26/2017. KeepGoingTranslator should keep going no mater what.
-     if (Rose::KeepGoing::g_keep_going)
-        {
-          finalCompiledExitStatus = 0;
-        }
-
-     return finalCompiledExitStatus;
+     return compileOutputExitStatus(this, returnValueForRose, returnValueForCompiler);
    }
 
 
@@ -5405,6 +5550,16 @@ SgProject::compileOutput()
 
           bool multifile_support_compile_only_flag = false;
 
+       // The backend compiles of the files are independent, so (without -rose:keep_going, which recovers from failures
+       // one file at a time) they can run concurrently: the loop below only builds their command lines.
+          vector<DeferredBackendCompile> backendCompiles;
+          bool concurrentBackendCompiles = Rose::Cmdline::Backend::jobs != 1 && numberOfFiles() > 1 &&
+                                           get_keep_going() == false && Rose::KeepGoing::g_keep_going == false;
+          if (concurrentBackendCompiles == true)
+             {
+               deferredBackendCompiles = &backendCompiles;
+             }
+
        // case 2: compilation  for each file
        // Typical case
              {
@@ -5482,6 +5637,34 @@ SgProject::compileOutput()
                   }
              }
 
+       // Run the backend compiles; their output is written in the order of the files, and linking starts after all of them.
+          if (concurrentBackendCompiles == true)
+             {
+               deferredBackendCompiles = NULL;
+
+               vector<vector<string> > commandLines;
+               for (size_t j = 0; j < backendCompiles.size(); j++)
+                  {
+                    commandLines.push_back(backendCompiles[j].commandLine);
+                  }
+
+               vector<int> statuses = systemFromVectors(commandLines, Rose::Cmdline::Backend::jobs);
+
+               for (size_t j = 0; j < backendCompiles.size(); j++)
+                  {
+                    if (statuses[j] != 0)
+                       {
+                         backendCompiles[j].file->set_backendCompilerErrorCode(-1);
+                       }
+
+                    int localErrorCode = compileOutputExitStatus(backendCompiles[j].file, 0, statuses[j]);
+                    if (localErrorCode > errorCode)
+                       {
+                         errorCode = localErrorCode;
+                       }
+                  }
+             }
+
 #if DEBUG_PROJECT_COMPILE_COMMAND_LINE
           printf ("In SgProject::compileOutput(): get_compileOnly() = %s \n",get_compileOnly() ? "true" : "false");
           printf ("In SgProject::compileOutput(): errorCode = %d \n",errorCode);
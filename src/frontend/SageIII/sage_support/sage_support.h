@@ -64,6 +64,7 @@ namespace Rose {
 namespace Frontend {
   int Run(SgProject* project);
   int RunSerial(SgProject* project);
+  int RunParallel(SgProject* project);
 }// ::Rose::Frontend
 }
 
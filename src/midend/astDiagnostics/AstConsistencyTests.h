@@ -257,9 +257,11 @@ public:
 };
 
 // class TestMangledNames : public AstSimpleProcessing
-class TestMangledNames : public ROSE_VisitTraversal
+class TestMangledNames : public ROSE_ParallelVisitTraversal
    {
   // This class uses a traversal to test the generation of mangled names.
+  // The memory pools are traversed in parallel, each thread records the sizes of the mangled names it
+  // generated in its own MangledNameSizes (summed up into the saved_* data members after the traversal).
 
      public:
      virtual ~TestMangledNames() {};
@@ -275,8 +277,20 @@ class TestMangledNames : public ROSE_VisitTraversal
        // DQ (8/28/2006): Added constructor to permit data members to be set properly
           TestMangledNames();
 
+          void setNumberOfThreads ( size_t numberOfThreads ) override;
+
       //! visit function required for traversal
-          void visit ( SgNode* node );
+          void visit ( SgNode* node, size_t thread ) override;
+
+     private:
+          struct MangledNameSizes
+             {
+               unsigned long maxSize;
+               unsigned long totalSize;
+               unsigned long number;
+             };
+
+          std::vector<MangledNameSizes> threadMangledNameSizes;
    };
 
 #if 0
@@ -308,15 +322,15 @@ void testParentPointersOfSymbols();
     (e.g. declarations that are hidden from the AST traversal). This traversal traverses the 
     whole AST using the memory pool traversal.
  */
-class TestParentPointersInMemoryPool : public ROSE_VisitTraversal
+class TestParentPointersInMemoryPool : public ROSE_ParallelVisitTraversal
    {
      public:
           virtual ~TestParentPointersInMemoryPool() {};
       //! static function to do test on any IR node
           static void test();
 
-      //! Required traversal function
-          void visit (SgNode* node);
+      //! Required traversal function (called concurrently for different IR nodes)
+          void visit (SgNode* node, size_t thread) override;
    };
 
 
@@ -212,6 +212,10 @@ class ROSE_DLL_API AstPerformance
           static void startTimer ( RoseTimeType & time );
           static void accumulateTime ( RoseTimeType & startTime, double & accumulatedTime, double & numberFunctionCalls );
 
+       // Records the time accumulated by accumulateTime() as a processing phase of the innermost performance monitor
+       // (used for the passes run together in one traversal, which can not each have a performance monitor of their own).
+          static void recordAccumulatedTime ( const std::string & s, const double & accumulatedTime );
+
      protected:
        // Storage of all performance information about 
        // processing phases saved here for later processing.
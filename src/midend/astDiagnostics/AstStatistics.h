@@ -145,6 +145,9 @@ class AstNodeMemoryPoolStatistics : public ROSE_VisitTraversal
 
      private:
           StatisticsContainerType numNodeTypes;
+
+       // Number of IR nodes of each variant in the memory pools (counted by the constructor).
+          std::vector<size_t> numberOfNodesByVariant;
    };
 
 // end of "ROSE_Statistics" namespace
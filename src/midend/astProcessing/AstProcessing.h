@@ -156,9 +156,36 @@ protected:
     // successor container.
     void set_useDefaultIndexBasedTraversal(bool);
 private:
+    // One entry of the explicit traversal stack: a node whose successors
+    // are being visited, the inherited attribute computed at that node, and
+    // the position of the next successor to visit.
+    struct TraversalFrame
+    {
+        SgNode *node;
+        InheritedAttributeType inheritedValue;
+        size_t numberOfSuccessors;
+        size_t nextSuccessor;
+        // start of this node's successors in successorsStack (only used if
+        // the traversal is not index based)
+        size_t successorsOffset;
+        // true if the successors of this node must be checked with
+        // SgTreeTraversal_inFileToTraverse() (see childInFileToTraverse())
+        bool checkSuccessorFiles;
+
+        TraversalFrame(SgNode *n, const InheritedAttributeType &inh)
+          : node(n), inheritedValue(inh), numberOfSuccessors(0),
+            nextSuccessor(0), successorsOffset(0), checkSuccessorFiles(false)
+        {
+        }
+    };
+    typedef std::vector<TraversalFrame> TraversalStack;
+
     void performTraversal(SgNode *basenode,
             InheritedAttributeType inheritedValue,
             t_traverseOrder travOrder);
+    void pushTraversalFrame(TraversalStack &stack, SgNode *node,
+            const InheritedAttributeType &inheritedValue);
+    bool childInFileToTraverse(const TraversalFrame &frame, SgNode *child);
     SynthesizedAttributeType traversalResult();
 
     bool useDefaultIndexBasedTraversal;
@@ -169,6 +196,15 @@ private:
     // automagically called with the appropriate stack frame, which
     // behaves like a non-resizable std::vector
     SynthesizedAttributesList *synthesizedAttributes;
+
+    // The explicit stack used by performTraversal(); kept between
+    // traversals so that its storage is allocated only once per traversal
+    // object. successorsStack holds the successor containers of all nodes
+    // on the stack (for traversals that are not index based) and
+    // successorsScratch is passed to setNodeSuccessors().
+    TraversalStack traversalStackCache;
+    SuccessorsContainer successorsStack;
+    SuccessorsContainer successorsScratch;
 };
 
 
@@ -176,6 +212,12 @@ private:
 template <class InheritedAttributeType, class SynthesizedAttributeType>
 class AstCombinedTopDownBottomUpProcessing;
 
+template <class InheritedAttributeType, class SynthesizedAttributeType>
+class AstSharedMemoryParallelTopDownBottomUpPartition;
+
+template <class InheritedAttributeType, class SynthesizedAttributeType>
+class AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing;
+
 template <class InheritedAttributeType, class SynthesizedAttributeType>
 class AstTopDownBottomUpProcessing
     : public SgTreeTraversal<InheritedAttributeType, SynthesizedAttributeType>
@@ -200,6 +242,8 @@ public:
     
 
     friend class AstCombinedTopDownBottomUpProcessing<InheritedAttributeType, SynthesizedAttributeType>;
+    friend class AstSharedMemoryParallelTopDownBottomUpPartition<InheritedAttributeType, SynthesizedAttributeType>;
+    friend class AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing<InheritedAttributeType, SynthesizedAttributeType>;
 
 protected:
     //! pure virtual function which must be implemented to compute the inherited attribute at a node
@@ -746,6 +790,70 @@ traverse(SgNode *node, InheritedAttributeType inheritedValue,
 
 
 
+// Pushes the frame for a node that is to be traversed; the inherited
+// attribute must already have been evaluated at that node.
+template<class InheritedAttributeType, class SynthesizedAttributeType>
+void
+SgTreeTraversal<InheritedAttributeType, SynthesizedAttributeType>::
+pushTraversalFrame(TraversalStack &stack, SgNode *node,
+        const InheritedAttributeType &inheritedValue)
+   {
+     stack.push_back(TraversalFrame(node, inheritedValue));
+     TraversalFrame &frame = stack.back();
+
+  // Visit the traversable data members of this AST node.
+  // GB (09/25/2007): Added support for index-based traversals. The useDefaultIndexBasedTraversal flag tells us
+  // whether to use successor containers or direct index-based access to the node's successors.
+     if (!useDefaultIndexBasedTraversal)
+        {
+       // The successors of all nodes on the stack share one container; the
+       // frame remembers where its own successors start.
+          successorsScratch.clear();
+          setNodeSuccessors(node, successorsScratch);
+          frame.successorsOffset = successorsStack.size();
+          frame.numberOfSuccessors = successorsScratch.size();
+          successorsStack.insert(successorsStack.end(), successorsScratch.begin(), successorsScratch.end());
+        }
+       else
+        {
+          frame.numberOfSuccessors = node->get_numberOfTraversalSuccessors();
+        }
+
+  // Only the successors of global scopes and namespace definitions can be
+  // excluded from a traversal within a file, see childInFileToTraverse().
+     frame.checkSuccessorFiles = traversalConstraint
+                                 && (isSgGlobal(node) != NULL || isSgNamespaceDefinitionStatement(node) != NULL);
+   }
+
+
+// Equivalent to SgTreeTraversal_inFileToTraverse(child, traversalConstraint, fileToVisit),
+// but the check is only done at the boundaries of the subtrees that can be
+// excluded: SgTreeTraversal_inFileToTraverse() accepts every node whose
+// parent is neither a global scope nor a namespace definition (such nodes
+// are considered to be code, not a header), so a child whose parent is the
+// node it was reached from is accepted without looking at its file info
+// unless that node is such a scope.
+template<class InheritedAttributeType, class SynthesizedAttributeType>
+inline bool
+SgTreeTraversal<InheritedAttributeType, SynthesizedAttributeType>::
+childInFileToTraverse(const TraversalFrame &frame, SgNode *child)
+   {
+     if (traversalConstraint == false)
+          return true;
+
+     if (frame.checkSuccessorFiles == false && child->get_parent() == frame.node)
+          return true;
+
+     return SgTreeTraversal_inFileToTraverse(child, traversalConstraint, fileToVisit);
+   }
+
+
+// The traversal used to recurse once per node, which overflowed the
+// C++ stack on deeply nested ASTs (e.g. long expression chains in generated
+// code). It now keeps its own stack of TraversalFrame objects; the order in
+// which the attribute evaluation functions are called, and the contents of
+// the stack of synthesized attributes, are the same as for the recursive
+// version.
 template<class InheritedAttributeType, class SynthesizedAttributeType>
 void
 SgTreeTraversal<InheritedAttributeType, SynthesizedAttributeType>::
@@ -753,112 +861,92 @@ performTraversal(SgNode* node,
         InheritedAttributeType inheritedValue,
         t_traverseOrder treeTraversalOrder)
    {
-    //cout << "In SgNode version" << endl;
   // 1. node can be a null pointer, only traverse it if !
-
   //    (since the SuccessorContainer is order preserving we require 0 values as well!)
   // 2. inFileToTraverse is false if we are trying to go to a different file (than the input file)
   //    and only if traverseInputFiles was invoked, otherwise it's always true
-
-     if (node && SgTreeTraversal_inFileToTraverse(node, traversalConstraint, fileToVisit))
+     if (node == NULL || !SgTreeTraversal_inFileToTraverse(node, traversalConstraint, fileToVisit))
         {
-       // In case of a preorder traversal call the function to be applied to each node of the AST
-       // GB (7/6/2007): Because AstPrePostProcessing was introduced, a
-       // treeTraversalOrder can now be pre *and* post at the same time! The
-       // == comparison was therefore replaced by a bit mask check.
-          if (treeTraversalOrder & preorder)
-               inheritedValue = evaluateInheritedAttribute(node, inheritedValue);
-  
-       // Visit the traversable data members of this AST node.
-       // GB (09/25/2007): Added support for index-based traversals. The useDefaultIndexBasedTraversal flag tells us
-       // whether to use successor containers or direct index-based access to the node's successors.
-          AstSuccessorsSelectors::SuccessorsContainer succContainer;
-          size_t numberOfSuccessors;
-          if (!useDefaultIndexBasedTraversal)
-             {
-               setNodeSuccessors(node, succContainer);
-               numberOfSuccessors = succContainer.size();
-             }
-            else
-             {
-               numberOfSuccessors = node->get_numberOfTraversalSuccessors();
-             }
+          if (treeTraversalOrder & postorder)
+               synthesizedAttributes->push(defaultSynthesizedAttribute(inheritedValue));
+          return;
+        }
 
-#if 0
-       // DQ (8/17/2018): Add support for debugging.
-          printf ("In SgTreeTraversal<>::performTraversal(): node = %p = %s numberOfSuccessors = %zu \n",node,node->class_name().c_str(),numberOfSuccessors);
-#endif
+  // Reuse the storage of the previous traversal. The cache is taken over by
+  // this call (and given back at the end) so that a traversal started from
+  // one of the evaluation functions uses a stack of its own.
+     TraversalStack stack;
+     stack.swap(traversalStackCache);
+     ROSE_ASSERT(stack.empty() == true);
+     const size_t successorsStackBase = successorsStack.size();
+
+  // In case of a preorder traversal call the function to be applied to each node of the AST
+  // GB (7/6/2007): Because AstPrePostProcessing was introduced, a
+  // treeTraversalOrder can now be pre *and* post at the same time! The
+  // == comparison was therefore replaced by a bit mask check.
+     if (treeTraversalOrder & preorder)
+          inheritedValue = evaluateInheritedAttribute(node, inheritedValue);
+     pushTraversalFrame(stack, node, inheritedValue);
+
+     while (stack.empty() == false)
+        {
+          TraversalFrame &frame = stack.back();
 
-          for (size_t idx = 0; idx < numberOfSuccessors; idx++)
+          if (frame.nextSuccessor < frame.numberOfSuccessors)
              {
+               size_t idx = frame.nextSuccessor++;
                SgNode *child = NULL;
-
                if (useDefaultIndexBasedTraversal)
-                  {
-                 // ROSE_ASSERT(node->get_traversalSuccessorByIndex(idx) != NULL || node->get_traversalSuccessorByIndex(idx) == NULL);
-                    child = node->get_traversalSuccessorByIndex(idx);
-
-                 // DQ (4/21/2014): Valgrind test to isolate uninitialised read reported where child is read below.
-                    ROSE_ASSERT(child == NULL || child != NULL);
-                  }
+                    child = frame.node->get_traversalSuccessorByIndex(idx);
                  else
-                  {
-                 // ROSE_ASSERT(succContainer[idx] != NULL || succContainer[idx] == NULL);
-                    child = succContainer[idx];
-
-                 // DQ (4/21/2014): Valgrind test to isolate uninitialised read reported where child is read below.
-                    ROSE_ASSERT(child == NULL || child != NULL);
-                  }
+                    child = successorsStack[frame.successorsOffset + idx];
 
-#if 0
-            // DQ (8/17/2018): Add support for debugging.
-               printf ("In SgTreeTraversal<>::performTraversal(): child = %p \n",child);
-#endif
-
-               if (child != NULL)
+               if (child != NULL && childInFileToTraverse(frame, child))
                   {
-#if 0
-                 // DQ (8/17/2018): Add support for debugging.
-                    printf ("In SgTreeTraversal<>::performTraversal(): child = %p = %s \n",child,child->class_name().c_str());
-#endif
-                    performTraversal(child, inheritedValue, treeTraversalOrder);
-                   
-                 // ENDEDIT
+                 // Evaluate before pushing, the push may move the frame.
+                    if (treeTraversalOrder & preorder)
+                       {
+                         InheritedAttributeType childInheritedValue = evaluateInheritedAttribute(child, frame.inheritedValue);
+                         pushTraversalFrame(stack, child, childInheritedValue);
+                       }
+                      else
+                       {
+                         pushTraversalFrame(stack, child, frame.inheritedValue);
+                       }
                   }
                  else
                   {
-                 // null pointer (not traversed): we put the default value(s) of SynthesizedAttribute onto the stack
+                 // null pointer or node in another file (not traversed): we put the default value(s) of
+                 // SynthesizedAttribute onto the stack
                     if (treeTraversalOrder & postorder)
-                         synthesizedAttributes->push(defaultSynthesizedAttribute(inheritedValue));
+                         synthesizedAttributes->push(defaultSynthesizedAttribute(frame.inheritedValue));
                   }
              }
-
-       // In case of a postorder traversal call the function to be applied to each node of the AST
-       // GB (7/6/2007): Because AstPrePostProcessing was introduced, a
-       // treeTraversalOrder can now be pre *and* post at the same time! The
-       // == comparison was therefore replaced by a bit mask check.
-       // The call to evaluateInheritedAttribute at this point also had to be
-       // changed; it was never elegant anyway as we were not really
-       // evaluating attributes here.
-          if (treeTraversalOrder & postorder)
+            else
              {
-            // Now that every child's synthesized attributes are on the stack:
-            // Tell the stack how big the stack frame containing those
-            // attributes is to be, and pass that frame to
-            // evaluateSynthesizedAttribute(); then replace those results by
-            // pushing the computed value onto the stack (which pops off the
-            // previous stack frame).
-               synthesizedAttributes->setFrameSize(numberOfSuccessors);
-               ROSE_ASSERT(synthesizedAttributes->size() == numberOfSuccessors);
-               synthesizedAttributes->push(evaluateSynthesizedAttribute(node, inheritedValue, *synthesizedAttributes));
+            // In case of a postorder traversal call the function to be applied to each node of the AST
+               if (treeTraversalOrder & postorder)
+                  {
+                 // Now that every child's synthesized attributes are on the stack:
+                 // Tell the stack how big the stack frame containing those
+                 // attributes is to be, and pass that frame to
+                 // evaluateSynthesizedAttribute(); then replace those results by
+                 // pushing the computed value onto the stack (which pops off the
+                 // previous stack frame).
+                    synthesizedAttributes->setFrameSize(frame.numberOfSuccessors);
+                    ROSE_ASSERT(synthesizedAttributes->size() == frame.numberOfSuccessors);
+                    synthesizedAttributes->push(evaluateSynthesizedAttribute(frame.node, frame.inheritedValue, *synthesizedAttributes));
+                  }
+
+               if (!useDefaultIndexBasedTraversal)
+                    successorsStack.resize(frame.successorsOffset);
+               stack.pop_back();
              }
         }
-       else // if (node && inFileToTraverse(node))
-        {
-          if (treeTraversalOrder & postorder)
-               synthesizedAttributes->push(defaultSynthesizedAttribute(inheritedValue));
-        }
-       } // function body
+
+     ROSE_ASSERT(successorsStack.size() == successorsStackBase);
+     stack.swap(traversalStackCache);
+   } // function body
 
 
 // GB (05/30/2007)
@@ -8,54 +8,49 @@
 
 #include "rosePublicConfig.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "AstProcessing.h"
 
 // Class containing all the information needed to synchronize parallelizable traversals. All traversals running
-// synchronously must have a shallow copy of this (they all need the same pointers!), the default copy mechanism takes
-// care of that.
-struct AstSharedMemoryParallelProcessingSynchronizationInfo
+// synchronously must have a copy of this; the copies share the synchronization state, which is released when the last
+// copy is destroyed.
+struct ROSE_DLL_API AstSharedMemoryParallelProcessingSynchronizationInfo
 {
-#ifdef _REENTRANT                                       // user wants mult-thread support? (e.g., g++ -pthread)?
-# ifdef ROSE_HAVE_PTHREAD_H                             // POSIX threads are available?
-    // mutex that controls access to the global stuff here
-    pthread_mutex_t *mutex;
-    // signal broadcast by last worker thread to arrive at a synchronization point
-    pthread_cond_t *synchronizationEvent;
-    // signal sent by workers when they exit
-    pthread_cond_t *threadFinishedEvent;
-# else
-#  ifdef _MSC_VER
-#   pragma message ("POSIX threads are unavailable on this platform");
-#  else
-#   warning "POSIX threads are unavailable on this platform."
-#  endif
-# endif
-#endif
-
-    // global counter of the number of threads that are still working (i.e.
-    // have not sent a synchronizationEvent)
-    size_t *workingThreads;
-    // global counter of the number of threads that have completely finished
-    // (i.e. have traversed the whole AST)
-    size_t *finishedThreads;
+    struct SharedState
+    {
+        // mutex that controls access to the global stuff here
+        std::mutex mutex;
+        // signal broadcast by last worker thread to arrive at a synchronization point
+        std::condition_variable synchronizationEvent;
+        // number of threads that have not finished their traversal yet
+        size_t participatingThreads;
+        // number of participating threads that have not arrived at the
+        // current synchronization point yet
+        size_t workingThreads;
+        // incremented each time all participating threads have arrived at a
+        // synchronization point; the threads waiting there wait for it to change
+        size_t generation;
+    };
+
+    std::shared_ptr<SharedState> state;
     // number of nodes to be visited by each traversal before they are
     // supposed to synchronize
     size_t synchronizationWindowSize;
 
     AstSharedMemoryParallelProcessingSynchronizationInfo(size_t numberOfThreads, size_t synchronizationWindowSize);
-    ~AstSharedMemoryParallelProcessingSynchronizationInfo();
-
-#if 1
- // We can't implement this as private since it is required.  So we have a potential double free error here.
- // private:
- // DQ (9/13/2011): This copy constructor was built because static analysis tools (made it private to force compile time error if used).
-    AstSharedMemoryParallelProcessingSynchronizationInfo( const AstSharedMemoryParallelProcessingSynchronizationInfo & X );
-#endif
 };
 
 // Class containing the code needed for synchronization of parallelizable traversals. The parallelizable processing
 // classes inherit privately from this because the code is the same for all of them.
-class AstSharedMemoryParallelProcessingSynchronizationBase
+class ROSE_DLL_API AstSharedMemoryParallelProcessingSynchronizationBase
 {
 protected:
     AstSharedMemoryParallelProcessingSynchronizationBase(const AstSharedMemoryParallelProcessingSynchronizationInfo &);
@@ -66,7 +61,66 @@ protected:
 
 private:
     AstSharedMemoryParallelProcessingSynchronizationInfo syncInfo;
-    size_t numberOfThreads;
+};
+
+// Work-stealing thread pool used by the partitioned traversals below. Each worker owns a queue of tasks; it takes the
+// tasks it submitted itself from the back of its own queue and, once that is empty, steals the oldest tasks from the
+// queues of the other workers. The thread that creates the pool is worker 0, it runs tasks only while it waits in
+// runUntil(); the other numberOfThreads()-1 workers are threads owned by the pool. Tasks may submit further tasks and
+// wait for them with runUntil(), but they must not throw.
+class ROSE_DLL_API AstSharedMemoryParallelWorkStealingPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // 0 selects one worker per hardware thread
+    explicit AstSharedMemoryParallelWorkStealingPool(size_t numberOfThreads = 0);
+    ~AstSharedMemoryParallelWorkStealingPool();
+
+    size_t numberOfThreads() const;
+
+    void submit(const Task &task);
+
+    // runs queued tasks in the calling thread until finished() returns true
+    void runUntil(const std::function<bool()> &finished);
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    size_t currentWorker() const;
+    bool runOneTask(size_t worker);
+    void workerLoop(size_t worker);
+
+    std::vector<std::unique_ptr<WorkerQueue> > queues;
+    std::vector<std::thread> workers;
+    // number of tasks in all queues
+    std::atomic<size_t> queuedTasks;
+    std::atomic<bool> stopping;
+    std::mutex idleMutex;
+    std::condition_variable idleEvent;
+
+    AstSharedMemoryParallelWorkStealingPool(const AstSharedMemoryParallelWorkStealingPool &);
+    AstSharedMemoryParallelWorkStealingPool &operator=(const AstSharedMemoryParallelWorkStealingPool &);
+};
+
+// The partitioned traversals split a single AST into subtrees that can be traversed independently of each other: the
+// partition roots are the function definitions, class definitions and namespace definitions below the node the
+// traversal is started from (which may in turn contain partition roots). The part of the AST above a set of partition
+// roots is traversed by one thread, which submits the partitions to the pool as it finds them and waits for their
+// results where they are needed; so a traversal only runs concurrently with traversals of disjoint subtrees.
+class ROSE_DLL_API AstSharedMemoryParallelPartitioning
+{
+public:
+    static bool isPartitionRoot(SgNode *node);
+
+    // Successors of node as seen by the traversal of the partition starting at partitionRoot: nodes that are the roots
+    // of other partitions have no successors.
+    static void selectPartitionSuccessors(SgNode *partitionRoot, SgNode *node,
+            AstSuccessorsSelectors::SuccessorsContainer &succContainer);
 };
 
 // TOP DOWN BOTTOM UP parallel traversals
@@ -137,6 +191,120 @@ private:
     size_t synchronizationWindowSize;
 };
 
+// PARTITIONED TOP DOWN BOTTOM UP traversals
+
+// Traversal of one partition of the AST (see AstSharedMemoryParallelPartitioning) with the attribute evaluation
+// functions of an AstTopDownBottomUpProcessing. The partitions below the partition root are submitted to the pool by
+// a first, top-down pass over the rest of the partition; a second, bottom-up pass computes the synthesized attributes
+// and waits for the result of each of these partitions at its root. The user will probably never need to instantiate
+// this class, they should use AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing instead.
+template <class InheritedAttributeType, class SynthesizedAttributeType>
+class AstSharedMemoryParallelTopDownBottomUpPartition
+{
+public:
+    typedef AstTopDownBottomUpProcessing<InheritedAttributeType, SynthesizedAttributeType> TraversalType;
+    typedef typename TraversalType::SynthesizedAttributesList SynthesizedAttributesList;
+
+    AstSharedMemoryParallelTopDownBottomUpPartition(TraversalType &traversal,
+            AstSharedMemoryParallelWorkStealingPool &pool, SgNode *partitionRoot);
+
+    SynthesizedAttributeType traverse(InheritedAttributeType inheritedValue);
+
+private:
+    // A partition below partitionRoot, traversed by a task of the pool.
+    struct Subpartition
+    {
+        SgNode *root;
+        InheritedAttributeType inheritedValue;
+        SynthesizedAttributeType result;
+        std::atomic<bool> finished;
+        std::exception_ptr error;
+
+        Subpartition(SgNode *root, const InheritedAttributeType &inheritedValue)
+          : root(root), inheritedValue(inheritedValue), result(), finished(false)
+        {
+        }
+    };
+
+    class TopDownPass : public SgTreeTraversal<InheritedAttributeType, DummyAttribute>
+    {
+    public:
+        typedef typename SgTreeTraversal<InheritedAttributeType, DummyAttribute>::SuccessorsContainer SuccessorsContainer;
+        typedef typename SgTreeTraversal<InheritedAttributeType, DummyAttribute>::SynthesizedAttributesList SynthesizedAttributesList;
+
+        explicit TopDownPass(AstSharedMemoryParallelTopDownBottomUpPartition &partition);
+
+    protected:
+        virtual InheritedAttributeType evaluateInheritedAttribute(SgNode *astNode, InheritedAttributeType inheritedValue);
+        virtual DummyAttribute evaluateSynthesizedAttribute(SgNode *astNode, InheritedAttributeType inheritedValue,
+                SynthesizedAttributesList l);
+        virtual void setNodeSuccessors(SgNode *node, SuccessorsContainer &succContainer);
+
+    private:
+        AstSharedMemoryParallelTopDownBottomUpPartition &partition;
+    };
+
+    // The inherited attribute of this pass is the index of the node's inherited attribute in inheritedValues.
+    class BottomUpPass : public SgTreeTraversal<size_t, SynthesizedAttributeType>
+    {
+    public:
+        typedef typename SgTreeTraversal<size_t, SynthesizedAttributeType>::SuccessorsContainer SuccessorsContainer;
+        typedef typename SgTreeTraversal<size_t, SynthesizedAttributeType>::SynthesizedAttributesList SynthesizedAttributesList;
+
+        explicit BottomUpPass(AstSharedMemoryParallelTopDownBottomUpPartition &partition);
+
+    protected:
+        virtual size_t evaluateInheritedAttribute(SgNode *astNode, size_t parentIndex);
+        virtual SynthesizedAttributeType evaluateSynthesizedAttribute(SgNode *astNode, size_t index,
+                SynthesizedAttributesList l);
+        virtual SynthesizedAttributeType defaultSynthesizedAttribute(size_t parentIndex);
+        virtual void setNodeSuccessors(SgNode *node, SuccessorsContainer &succContainer);
+
+    private:
+        AstSharedMemoryParallelTopDownBottomUpPartition &partition;
+        size_t nextIndex;
+    };
+
+    InheritedAttributeType enterNode(SgNode *astNode, const InheritedAttributeType &inheritedValue);
+    SynthesizedAttributeType leaveNode(SgNode *astNode, size_t index, SynthesizedAttributesList l);
+    SynthesizedAttributeType defaultAttribute(size_t parentIndex);
+    void waitForSubpartitions();
+
+    TraversalType &traversal;
+    AstSharedMemoryParallelWorkStealingPool &pool;
+    SgNode *partitionRoot;
+    // inherited attributes of the nodes of this partition in preorder, the
+    // roots of subpartitions excluded
+    std::vector<InheritedAttributeType> inheritedValues;
+    // subpartitions in preorder (std::deque keeps them in place)
+    std::deque<Subpartition> subpartitions;
+    size_t nextSubpartition;
+};
+
+// Class for data-parallel execution of a single traversal: the partitions of the AST are traversed concurrently on a
+// work-stealing pool of threads. The attribute evaluation functions are therefore called concurrently for nodes in
+// different partitions and must not modify state that is shared between partitions; atTraversalStart() and
+// atTraversalEnd() are called once, in the calling thread. The synthesized attributes computed at partition roots are
+// passed to the parent node in the order of its successors, so the result of traverseInParallel() is the same as that of
+// traverse(). The default successors are used, regardless of the traversal's set_useDefaultIndexBasedTraversal().
+template <class InheritedAttributeType, class SynthesizedAttributeType>
+class AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing
+{
+public:
+    typedef AstTopDownBottomUpProcessing<InheritedAttributeType, SynthesizedAttributeType> TraversalType;
+
+    // 0 threads selects one thread per hardware thread
+    AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing(TraversalType &traversal, size_t numberOfThreads = 0);
+
+    SynthesizedAttributeType traverseInParallel(SgNode *basenode, InheritedAttributeType inheritedValue);
+
+    void set_numberOfThreads(size_t threads);
+
+private:
+    TraversalType &traversal;
+    size_t numberOfThreads;
+};
+
 // TOP DOWN parallel traversals
 
 // Class representing a traversal that can run in parallel with some other instances of the same type. It is basically a
@@ -2,27 +2,6 @@
 #ifndef ASTSHAREDMEMORYPARALLELPROCESSING_C
 #define ASTSHAREDMEMORYPARALLELPROCESSING_C
 
-#include "rosePublicConfig.h"
-
-#ifdef _REENTRANT                                       // Does user want multi-thread support? (e.g., g++ -pthread)
-# ifdef ROSE_HAVE_PTHREAD_H                             // POSIX threads are available?
-#  include <pthread.h>
-# else
-   // This should all be switched to Boost Threads instead, which is more portable
-#  ifdef _MSC_VER
-#   pragma message ("POSIX threads are unavailable on this platform.")
-#  else
-#   warning "POSIX threads are unavailable on this platform."
-#  endif
-# endif
-#endif
-
-// Perhaps this code should be fixed so it works on a single thread when multi-thread support is disabled by the user.
-// Until then, I am commenting out this entire file when multi-threading support is not configured. [Robb P. Matzke 2015-03-14]
-#ifdef _REENTRANT                                       // Does the user want multi-threaded support? (e.g., g++ -pthread)
-
-
-
 #include "AstSharedMemoryParallelProcessing.h"
 
 // Throughout this file, I is the InheritedAttributeType, S is the
@@ -81,45 +60,21 @@ atTraversalEnd()
     }
 }
 
-// This class holds the arguments to a traversal thread: The parallelizable
-// traversal class that contains a number of traversals, the node to start the
-// traversal from, and the list of initial inherited values.
-template <class I, class S>
-struct AstSharedMemoryParallelTopDownBottomUpThreadArgs
-{
-    AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S> *traversal;
-    SgNode *basenode;
-    typename AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S>::InheritedAttributeTypeList *inheritedValues;
-
-    AstSharedMemoryParallelTopDownBottomUpThreadArgs(
-            AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S> *traversal,
-            SgNode *basenode,
-            typename AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S>::InheritedAttributeTypeList *inheritedValues)
-        : traversal(traversal), basenode(basenode), inheritedValues(inheritedValues)
-    {
-    }
-};
-
-// This is the function that is executed in each thread. It basically unpacks
-// its arguments and starts the traversal on them; the traversal's final
-// result is returned. Synchronization is built into the parallelizable
-// processing classes.
+// This is the function that is executed in each thread. It starts the
+// traversal and stores its final result. Synchronization is built into the
+// parallelizable processing classes.
 template <class I, class S>
-void *parallelTopDownBottomUpProcessingThread(void *p)
+void parallelTopDownBottomUpProcessingThread(
+        AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S> *traversal,
+        SgNode *basenode,
+        typename AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S>::InheritedAttributeTypeList *inheritedValues,
+        typename AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S>::SynthesizedAttributeTypeList **result)
 {
-    AstSharedMemoryParallelTopDownBottomUpThreadArgs<I, S> *threadArgs = (AstSharedMemoryParallelTopDownBottomUpThreadArgs<I, S> *) p;
-
-    AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S> *traversal = threadArgs->traversal;
-    SgNode *basenode = threadArgs->basenode;
-    typename AstSharedMemoryParallelizableTopDownBottomUpProcessing<I, S>::InheritedAttributeTypeList
-        *inheritedValues = threadArgs->inheritedValues;
-    delete threadArgs;
-
     // Set the flag that indicates that this is indeed a parallel traversal;
     // it is cleared by the traversal class itself when it is done.
     traversal->set_runningParallelTraversal(true);
     // Start the traversal.
-    return traversal->traverse(basenode, inheritedValues);
+    *result = traversal->traverse(basenode, inheritedValues);
 }
 
 template <class I, class S>
@@ -156,37 +111,27 @@ AstSharedMemoryParallelTopDownBottomUpProcessing<I, S>::traverseInParallel(
         begin = end;
     }
 
-#if defined(_REENTRANT) && defined(ROSE_HAVE_PTHREAD_H) // user wants multi-thread support and POSIX threads are available?
     // Start a thread for each of the parallelizable traversals with its share
-    // of the initial inherited attributes.
-    pthread_t *threads = new pthread_t[numberOfThreads];
+    // of the initial inherited attributes, then wait for all of them and
+    // grab their results.
+    std::vector<SynthesizedAttributeTypeList *> finalResults(numberOfThreads);
+    std::vector<std::thread> threads;
     for (i = 0; i < numberOfThreads; i++)
     {
-        pthread_create(&threads[i], NULL,
-                parallelTopDownBottomUpProcessingThread<I, S>,
-                new AstSharedMemoryParallelTopDownBottomUpThreadArgs<I, S>(
-                    parallelTraversals[i], basenode, parallelInheritedValues[i]));
+        threads.push_back(std::thread(parallelTopDownBottomUpProcessingThread<I, S>,
+                    parallelTraversals[i], basenode, parallelInheritedValues[i], &finalResults[i]));
     }
-
-    // Main "event loop" for the "master" thread: Simply wait for the
-    // condition that is signalled when a thread is completely done with its
-    // traversal. The counter tells us when we are finished.
-    pthread_mutex_lock(syncInfo.mutex);
-    while (*syncInfo.finishedThreads < numberOfThreads)
-        pthread_cond_wait(syncInfo.threadFinishedEvent, syncInfo.mutex);
-    pthread_mutex_unlock(syncInfo.mutex);
-
-    // Grab the results from each traversal.
-    std::vector<SynthesizedAttributeTypeList *> finalResults(numberOfThreads);
     for (i = 0; i < numberOfThreads; i++)
-        pthread_join(threads[i], (void **) &finalResults[i]);
-    delete[] threads;
-#endif
+        threads[i].join();
 
     // Flatten the nested list of traversal results.
     SynthesizedAttributeTypeList *flatFinalResults = new SynthesizedAttributeTypeList;
     for (i = 0; i < numberOfThreads; i++)
+    {
         std::copy(finalResults[i]->begin(), finalResults[i]->end(), std::back_inserter(*flatFinalResults));
+        delete finalResults[i];
+        delete parallelTraversals[i];
+    }
 
     // Done! Return the final results.
     return flatFinalResults;
@@ -282,48 +227,20 @@ atTraversalEnd()
     }
 }
 
-// This class holds the arguments to a traversal thread: The parallelizable
-// traversal class that contains a number of traversals, the node to start the
-// traversal from, and the list of initial inherited values.
-template <class I>
-struct AstSharedMemoryParallelTopDownThreadArgs
-{
-    AstSharedMemoryParallelizableTopDownProcessing<I> *traversal;
-    SgNode *basenode;
-    typename AstSharedMemoryParallelizableTopDownProcessing<I>::InheritedAttributeTypeList *inheritedValues;
-
-    AstSharedMemoryParallelTopDownThreadArgs(
-            AstSharedMemoryParallelizableTopDownProcessing<I> *traversal,
-            SgNode *basenode,
-            typename AstSharedMemoryParallelizableTopDownProcessing<I>::InheritedAttributeTypeList *inheritedValues)
-        : traversal(traversal), basenode(basenode), inheritedValues(inheritedValues)
-    {
-    }
-};
-
-// This is the function that is executed in each thread. It basically unpacks
-// its arguments and starts the traversal on them; the traversal's final
-// result is returned. Synchronization is built into the parallelizable
-// processing classes.
+// This is the function that is executed in each thread. It starts the
+// traversal; synchronization is built into the parallelizable processing
+// classes.
 template <class I>
-void *parallelTopDownProcessingThread(void *p)
+void parallelTopDownProcessingThread(
+        AstSharedMemoryParallelizableTopDownProcessing<I> *traversal,
+        SgNode *basenode,
+        typename AstSharedMemoryParallelizableTopDownProcessing<I>::InheritedAttributeTypeList *inheritedValues)
 {
-    AstSharedMemoryParallelTopDownThreadArgs<I> *threadArgs = (AstSharedMemoryParallelTopDownThreadArgs<I> *) p;
-
-    AstSharedMemoryParallelizableTopDownProcessing<I> *traversal = threadArgs->traversal;
-    SgNode *basenode = threadArgs->basenode;
-    typename AstSharedMemoryParallelizableTopDownProcessing<I>::InheritedAttributeTypeList
-        *inheritedValues = threadArgs->inheritedValues;
-    delete threadArgs;
-
     // Set the flag that indicates that this is indeed a parallel traversal;
     // it is cleared by the traversal class itself when it is done.
     traversal->set_runningParallelTraversal(true);
     // Start the traversal.
     traversal->traverse(basenode, inheritedValues);
-
-    // Need to return something.
-    return NULL;
 }
 
 template <class I>
@@ -360,29 +277,18 @@ AstSharedMemoryParallelTopDownProcessing<I>::traverseInParallel(
     }
 
     // Start a thread for each of the parallelizable traversals with its share
-    // of the initial inherited attributes.
-    pthread_t *threads = new pthread_t[numberOfThreads];
+    // of the initial inherited attributes, then wait for all of them.
+    std::vector<std::thread> threads;
     for (i = 0; i < numberOfThreads; i++)
     {
-        pthread_create(&threads[i], NULL,
-                parallelTopDownProcessingThread<I>,
-                new AstSharedMemoryParallelTopDownThreadArgs<I>(
+        threads.push_back(std::thread(parallelTopDownProcessingThread<I>,
                     parallelTraversals[i], basenode, parallelInheritedValues[i]));
     }
-
-    // Main "event loop" for the "master" thread: Simply wait for the
-    // condition that is signalled when a thread is completely done with its
-    // traversal. The counter tells us when we are finished.
-    pthread_mutex_lock(syncInfo.mutex);
-    while (*syncInfo.finishedThreads < numberOfThreads)
-        pthread_cond_wait(syncInfo.threadFinishedEvent, syncInfo.mutex);
-    pthread_mutex_unlock(syncInfo.mutex);
-
-    // Grab the results from each traversal.
-    std::vector<void *> finalResults(numberOfThreads);
     for (i = 0; i < numberOfThreads; i++)
-        pthread_join(threads[i], &finalResults[i]);
-    delete[] threads;
+    {
+        threads[i].join();
+        delete parallelTraversals[i];
+    }
 
     // Done!
 }
@@ -477,41 +383,20 @@ atTraversalEnd()
     }
 }
 
-// This class holds the arguments to a traversal thread: The parallelizable
-// traversal class that contains a number of traversals, and the node to start the
-// traversal from.
+// This is the function that is executed in each thread. It starts the
+// traversal and stores its final result. Synchronization is built into the
+// parallelizable processing classes.
 template <class S>
-struct AstSharedMemoryParallelBottomUpThreadArgs
-{
-    AstSharedMemoryParallelizableBottomUpProcessing<S> *traversal;
-    SgNode *basenode;
-
-    AstSharedMemoryParallelBottomUpThreadArgs(
-            AstSharedMemoryParallelizableBottomUpProcessing<S> *traversal,
-            SgNode *basenode)
-        : traversal(traversal), basenode(basenode)
-    {
-    }
-};
-
-// This is the function that is executed in each thread. It basically unpacks
-// its arguments and starts the traversal on them; the traversal's final
-// result is returned. Synchronization is built into the parallelizable
-// processing classes.
-template <class S>
-void *parallelBottomUpProcessingThread(void *p)
+void parallelBottomUpProcessingThread(
+        AstSharedMemoryParallelizableBottomUpProcessing<S> *traversal,
+        SgNode *basenode,
+        typename AstSharedMemoryParallelizableBottomUpProcessing<S>::SynthesizedAttributeTypeList **result)
 {
-    AstSharedMemoryParallelBottomUpThreadArgs<S> *threadArgs = (AstSharedMemoryParallelBottomUpThreadArgs<S> *) p;
-
-    AstSharedMemoryParallelizableBottomUpProcessing<S> *traversal = threadArgs->traversal;
-    SgNode *basenode = threadArgs->basenode;
-    delete threadArgs;
-
     // Set the flag that indicates that this is indeed a parallel traversal;
     // it is cleared by the traversal class itself when it is done.
     traversal->set_runningParallelTraversal(true);
     // Start the traversal.
-    return traversal->traverse(basenode);
+    *result = traversal->traverse(basenode);
 }
 
 template <class S>
@@ -541,34 +426,26 @@ AstSharedMemoryParallelBottomUpProcessing<S>::traverseInParallel(SgNode *basenod
         begin = end;
     }
 
-    // Start a thread for each of the parallelizable traversals.
-    pthread_t *threads = new pthread_t[numberOfThreads];
+    // Start a thread for each of the parallelizable traversals, then wait for
+    // all of them and grab their results.
+    std::vector<SynthesizedAttributeTypeList *> finalResults(numberOfThreads);
+    std::vector<std::thread> threads;
     for (i = 0; i < numberOfThreads; i++)
     {
-        pthread_create(&threads[i], NULL,
-                parallelBottomUpProcessingThread<S>,
-                new AstSharedMemoryParallelBottomUpThreadArgs<S>(
-                    parallelTraversals[i], basenode));
+        threads.push_back(std::thread(parallelBottomUpProcessingThread<S>,
+                    parallelTraversals[i], basenode, &finalResults[i]));
     }
-
-    // Main "event loop" for the "master" thread: Simply wait for the
-    // condition that is signalled when a thread is completely done with its
-    // traversal. The counter tells us when we are finished.
-    pthread_mutex_lock(syncInfo.mutex);
-    while (*syncInfo.finishedThreads < numberOfThreads)
-        pthread_cond_wait(syncInfo.threadFinishedEvent, syncInfo.mutex);
-    pthread_mutex_unlock(syncInfo.mutex);
-
-    // Grab the results from each traversal.
-    std::vector<SynthesizedAttributeTypeList *> finalResults(numberOfThreads);
     for (i = 0; i < numberOfThreads; i++)
-        pthread_join(threads[i], (void **) &finalResults[i]);
-    delete[] threads;
+        threads[i].join();
 
     // Flatten the nested list of traversal results.
     SynthesizedAttributeTypeList *flatFinalResults = new SynthesizedAttributeTypeList;
     for (i = 0; i < numberOfThreads; i++)
+    {
         std::copy(finalResults[i]->begin(), finalResults[i]->end(), std::back_inserter(*flatFinalResults));
+        delete finalResults[i];
+        delete parallelTraversals[i];
+    }
 
     // Done! Return the final results.
     return flatFinalResults;
@@ -611,5 +488,220 @@ AstSharedMemoryParallelBottomUpProcessing<S>::set_synchronizationWindowSize(size
 #endif
 }
 
-#endif
+// partitioned TOP DOWN BOTTOM UP implementation
+
+template <class I, class S>
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::
+AstSharedMemoryParallelTopDownBottomUpPartition(
+        typename AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::TraversalType &traversal,
+        AstSharedMemoryParallelWorkStealingPool &pool, SgNode *partitionRoot)
+    : traversal(traversal), pool(pool), partitionRoot(partitionRoot), nextSubpartition(0)
+{
+}
+
+template <class I, class S>
+S
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::traverse(I inheritedValue)
+{
+    if (partitionRoot == NULL)
+        return traversal.defaultSynthesizedAttribute(inheritedValue);
+
+    // The subpartitions refer to this object, so they must be finished before
+    // an exception may leave this function.
+    try
+    {
+        TopDownPass topDown(*this);
+        topDown.traverse(partitionRoot, inheritedValue, preorder);
+
+        BottomUpPass bottomUp(*this);
+        return bottomUp.traverse(partitionRoot, 0, preandpostorder);
+    }
+    catch (...)
+    {
+        waitForSubpartitions();
+        throw;
+    }
+}
+
+template <class I, class S>
+I
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::enterNode(SgNode *astNode, const I &inheritedValue)
+{
+    if (astNode != partitionRoot && AstSharedMemoryParallelPartitioning::isPartitionRoot(astNode))
+    {
+        // The inherited attribute at the subpartition root is evaluated by
+        // the subpartition's own traversal.
+        subpartitions.emplace_back(astNode, inheritedValue);
+        Subpartition *subpartition = &subpartitions.back();
+        TraversalType *t = &traversal;
+        AstSharedMemoryParallelWorkStealingPool *p = &pool;
+        pool.submit([subpartition, t, p]() {
+            try
+            {
+                AstSharedMemoryParallelTopDownBottomUpPartition<I, S> partition(*t, *p, subpartition->root);
+                subpartition->result = partition.traverse(subpartition->inheritedValue);
+            }
+            catch (...)
+            {
+                subpartition->error = std::current_exception();
+            }
+            subpartition->finished.store(true, std::memory_order_release);
+        });
+        return inheritedValue;
+    }
+
+    inheritedValues.push_back(traversal.evaluateInheritedAttribute(astNode, inheritedValue));
+    return inheritedValues.back();
+}
+
+template <class I, class S>
+S
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::leaveNode(SgNode *astNode, size_t index,
+        typename AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::SynthesizedAttributesList l)
+{
+    if (index != (size_t) -1)
+        return traversal.evaluateSynthesizedAttribute(astNode, inheritedValues[index], l);
+
+    // The bottom-up pass reaches the subpartitions in the same order as the
+    // top-down pass.
+    ROSE_ASSERT(nextSubpartition < subpartitions.size());
+    Subpartition &subpartition = subpartitions[nextSubpartition++];
+    ROSE_ASSERT(subpartition.root == astNode);
+
+    pool.runUntil([&subpartition]() { return subpartition.finished.load(std::memory_order_acquire); });
+    if (subpartition.error)
+        std::rethrow_exception(subpartition.error);
+    return subpartition.result;
+}
+
+template <class I, class S>
+S
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::defaultAttribute(size_t parentIndex)
+{
+    // only used for null successors, whose parent is never a subpartition root
+    return traversal.defaultSynthesizedAttribute(inheritedValues[parentIndex]);
+}
+
+template <class I, class S>
+void
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::waitForSubpartitions()
+{
+    for (size_t i = 0; i < subpartitions.size(); i++)
+    {
+        Subpartition &subpartition = subpartitions[i];
+        pool.runUntil([&subpartition]() { return subpartition.finished.load(std::memory_order_acquire); });
+    }
+}
+
+template <class I, class S>
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::TopDownPass::
+TopDownPass(AstSharedMemoryParallelTopDownBottomUpPartition<I, S> &partition)
+    : partition(partition)
+{
+    this->set_useDefaultIndexBasedTraversal(false);
+}
+
+template <class I, class S>
+I
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::TopDownPass::
+evaluateInheritedAttribute(SgNode *astNode, I inheritedValue)
+{
+    return partition.enterNode(astNode, inheritedValue);
+}
+
+template <class I, class S>
+DummyAttribute
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::TopDownPass::
+evaluateSynthesizedAttribute(SgNode *, I,
+        typename AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::TopDownPass::SynthesizedAttributesList)
+{
+    // not called, this is a preorder traversal
+    return defaultDummyAttribute;
+}
+
+template <class I, class S>
+void
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::TopDownPass::
+setNodeSuccessors(SgNode *node,
+        typename AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::TopDownPass::SuccessorsContainer &succContainer)
+{
+    AstSharedMemoryParallelPartitioning::selectPartitionSuccessors(partition.partitionRoot, node, succContainer);
+}
+
+template <class I, class S>
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::BottomUpPass::
+BottomUpPass(AstSharedMemoryParallelTopDownBottomUpPartition<I, S> &partition)
+    : partition(partition), nextIndex(0)
+{
+    this->set_useDefaultIndexBasedTraversal(false);
+}
+
+template <class I, class S>
+size_t
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::BottomUpPass::
+evaluateInheritedAttribute(SgNode *astNode, size_t)
+{
+    // Subpartition roots are marked by an invalid index, the other nodes are
+    // numbered in preorder like their entries in inheritedValues.
+    if (astNode != partition.partitionRoot && AstSharedMemoryParallelPartitioning::isPartitionRoot(astNode))
+        return (size_t) -1;
+    return nextIndex++;
+}
+
+template <class I, class S>
+S
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::BottomUpPass::
+evaluateSynthesizedAttribute(SgNode *astNode, size_t index,
+        typename AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::BottomUpPass::SynthesizedAttributesList l)
+{
+    return partition.leaveNode(astNode, index, l);
+}
+
+template <class I, class S>
+S
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::BottomUpPass::
+defaultSynthesizedAttribute(size_t parentIndex)
+{
+    return partition.defaultAttribute(parentIndex);
+}
+
+template <class I, class S>
+void
+AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::BottomUpPass::
+setNodeSuccessors(SgNode *node,
+        typename AstSharedMemoryParallelTopDownBottomUpPartition<I, S>::BottomUpPass::SuccessorsContainer &succContainer)
+{
+    AstSharedMemoryParallelPartitioning::selectPartitionSuccessors(partition.partitionRoot, node, succContainer);
+}
+
+template <class I, class S>
+AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing<I, S>::
+AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing(
+        typename AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing<I, S>::TraversalType &traversal,
+        size_t numberOfThreads)
+    : traversal(traversal), numberOfThreads(numberOfThreads)
+{
+}
+
+template <class I, class S>
+S
+AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing<I, S>::traverseInParallel(SgNode *basenode, I inheritedValue)
+{
+    AstSharedMemoryParallelWorkStealingPool pool(numberOfThreads);
+
+    traversal.atTraversalStart();
+    AstSharedMemoryParallelTopDownBottomUpPartition<I, S> partition(traversal, pool, basenode);
+    S result = partition.traverse(inheritedValue);
+    traversal.atTraversalEnd();
+
+    return result;
+}
+
+template <class I, class S>
+void
+AstSharedMemoryParallelPartitionedTopDownBottomUpProcessing<I, S>::set_numberOfThreads(size_t threads)
+{
+    numberOfThreads = threads;
+}
+
 #endif
@@ -67,6 +67,85 @@ private:
     size_t synchronizationWindowSize;
 };
 
+// partitioned SIMPLE processing class
+
+// Traversal of one partition of the AST (see AstSharedMemoryParallelPartitioning) with the visit() function of an
+// AstSimpleProcessing. The partitions below the partition root are submitted to the pool by a preorder pass over the
+// rest of the partition; for postorder traversals, a second pass visits the nodes after waiting for the partitions
+// below them. The user will probably never need to instantiate this class, they should use
+// AstSharedMemoryParallelPartitionedSimpleProcessing instead.
+class ROSE_DLL_API AstSharedMemoryParallelSimplePartition
+{
+public:
+    AstSharedMemoryParallelSimplePartition(AstSimpleProcessing &traversal,
+            AstSharedMemoryParallelWorkStealingPool &pool, SgNode *partitionRoot);
+
+    void traverse(t_traverseOrder treeTraverseOrder);
+
+private:
+    // A partition below partitionRoot, traversed by a task of the pool.
+    struct Subpartition
+    {
+        SgNode *root;
+        std::atomic<bool> finished;
+        std::exception_ptr error;
+
+        explicit Subpartition(SgNode *root)
+          : root(root), finished(false)
+        {
+        }
+    };
+
+    class PartitionPass : public SgTreeTraversal<DummyAttribute, DummyAttribute>
+    {
+    public:
+        explicit PartitionPass(AstSharedMemoryParallelSimplePartition &partition);
+
+    protected:
+        virtual DummyAttribute evaluateInheritedAttribute(SgNode *astNode, DummyAttribute inheritedValue);
+        virtual DummyAttribute evaluateSynthesizedAttribute(SgNode *astNode, DummyAttribute inheritedValue,
+                SynthesizedAttributesList l);
+        virtual void setNodeSuccessors(SgNode *node, SuccessorsContainer &succContainer);
+
+    private:
+        AstSharedMemoryParallelSimplePartition &partition;
+    };
+
+    void enterNode(SgNode *astNode);
+    void leaveNode(SgNode *astNode);
+    void waitForSubpartition(Subpartition &subpartition);
+    void waitForSubpartitions();
+
+    AstSimpleProcessing &traversal;
+    AstSharedMemoryParallelWorkStealingPool &pool;
+    SgNode *partitionRoot;
+    t_traverseOrder treeTraverseOrder;
+    // subpartitions in preorder (std::deque keeps them in place)
+    std::deque<Subpartition> subpartitions;
+    size_t nextSubpartition;
+};
+
+// Class for data-parallel execution of a single traversal: the partitions of the AST are traversed concurrently on a
+// work-stealing pool of threads, so visit() is called concurrently for nodes in different partitions and must be
+// thread-safe. A node is still visited after (preorder) or before (postorder) all of its ancestors, but the order of
+// the visits to nodes in different partitions is unspecified. atTraversalStart() and atTraversalEnd() are called once,
+// in the calling thread. The default successors are used, regardless of the traversal's
+// set_useDefaultIndexBasedTraversal().
+class ROSE_DLL_API AstSharedMemoryParallelPartitionedSimpleProcessing
+{
+public:
+    // 0 threads selects one thread per hardware thread
+    AstSharedMemoryParallelPartitionedSimpleProcessing(AstSimpleProcessing &traversal, size_t numberOfThreads = 0);
+
+    void traverseInParallel(SgNode *basenode, t_traverseOrder treeTraverseOrder);
+
+    void set_numberOfThreads(size_t threads);
+
+private:
+    AstSimpleProcessing &traversal;
+    size_t numberOfThreads;
+};
+
 // parallel PRE POST processing class
 
 // Class representing a traversal that can run in parallel with some other instances of the same type. It is basically a
@@ -55,6 +55,8 @@ private:
 // AstPrePostProcessing, but that results in a (barely) measurable
 // performance hit.
 class AstCombinedSimpleProcessing;
+class AstSharedMemoryParallelSimplePartition;
+class AstSharedMemoryParallelPartitionedSimpleProcessing;
 
 class ROSE_DLL_API AstSimpleProcessing
     : public SgTreeTraversal<DummyAttribute, DummyAttribute>
@@ -72,6 +74,8 @@ public:
     void traverseInputFiles(SgProject* projectNode, Order treeTraversalOrder);
 
     friend class AstCombinedSimpleProcessing;
+    friend class AstSharedMemoryParallelSimplePartition;
+    friend class AstSharedMemoryParallelPartitionedSimpleProcessing;
 
 protected:
     //! this method is called at every traversed node.
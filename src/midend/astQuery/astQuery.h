@@ -522,6 +522,78 @@ template<typename NodeFunctional>
     }
 
 
+  /*******************************************************
+   * The class
+   *    class AstParallelQuery
+   * traverses the memory pool with several threads and performs
+   * the action specified in a functional on every node. Each
+   * thread uses its own copy of the functional and its own
+   * result list, the lists are concatenated after the traversal.
+   *****************************************************/
+  template<typename NodeFunctional>
+    class AstParallelQuery : public ROSE_ParallelVisitTraversal
+  {
+    typedef typename NodeFunctional::result_type AstQueryReturnType;
+
+    NodeFunctional nodeFunc;
+    std::vector<NodeFunctional> nodeFuncs;
+    std::vector<AstQueryReturnType> listsOfNodes;
+
+    public:
+    AstParallelQuery(NodeFunctional funct) : nodeFunc(funct) {}
+
+    void setNumberOfThreads(size_t numberOfThreads) override
+    {
+      ROSE_ParallelVisitTraversal::setNumberOfThreads(numberOfThreads);
+      nodeFuncs.assign(numberOfThreads, nodeFunc);
+      listsOfNodes.assign(numberOfThreads, AstQueryReturnType());
+    }
+
+    void visit(SgNode* node, size_t thread) override
+    {
+      ROSE_ASSERT (node != NULL);
+      AstQueryNamespace::Merge(listsOfNodes[thread], nodeFuncs[thread](node));
+    }
+
+    //get the result from the query (the results of all threads)
+    AstQueryReturnType get_listOfNodes()
+    {
+      AstQueryReturnType listOfNodes;
+      for (size_t i = 0; i < listsOfNodes.size(); i++)
+        listOfNodes.insert(listOfNodes.end(), listsOfNodes[i].begin(), listsOfNodes[i].end());
+      return listOfNodes;
+    }
+  };
+
+  /********************************************************************************
+   * The function
+   *      queryMemoryPoolInParallel(NodeFunctional nodeFunc, VariantVector* targetVariantVector = NULL,
+   *                                size_t numberOfThreads = 0)
+   * is the same query as queryMemoryPool(), but the memory pool blocks are traversed by numberOfThreads
+   * threads (0 selects one thread per hardware thread). The functional is called concurrently (on
+   * copies made for each thread) and must not modify the AST; the order of the result is unspecified.
+   ********************************************************************************/
+  template<typename NodeFunctional>
+    typename NodeFunctional::result_type
+    queryMemoryPoolInParallel(NodeFunctional nodeFunc, VariantVector* targetVariantVector = NULL, size_t numberOfThreads = 0)
+    {
+      AstParallelQuery<NodeFunctional> astQuery(nodeFunc);
+
+      std::vector<ROSE_MemoryPoolBlock> blocks;
+      if (targetVariantVector == NULL) {
+        //Query the whole memory pool
+        collectMemoryPoolBlocks(blocks);
+      } else {
+        for (VariantVector::iterator it = targetVariantVector->begin(); it != targetVariantVector->end(); ++it)
+          collectMemoryPoolBlocks(blocks, *it);
+      }
+
+      traverseMemoryPoolBlocksInParallel(astQuery, blocks, numberOfThreads);
+
+      return astQuery.get_listOfNodes();
+    }
+
+
   /********************************************************************************
    * The function
    *      _Result querySubTree ( SgNode * subTree,
@@ -427,6 +427,24 @@ namespace NodeQuery
   queryMemoryPool(VariantVector& targetVariantVector);
 
 
+/********************************************************************************
+ * The functions
+ *  queryMemoryPoolInParallel(NodeFunctional nodeFunc, VariantVector* targetVariantVector = NULL, size_t numberOfThreads = 0)
+ *  queryMemoryPoolInParallel(VariantVector& targetVariantVector, size_t numberOfThreads = 0)
+ * are the same queries as queryMemoryPool(), but the memory pools are traversed by numberOfThreads
+ * threads (0 selects one thread per hardware thread). The order of the result is unspecified.
+ ********************************************************************************/
+  template<typename NodeFunctional>
+  NodeQuerySynthesizedAttributeType
+  queryMemoryPoolInParallel(NodeFunctional nodeFunc, VariantVector* targetVariantVector = NULL, size_t numberOfThreads = 0)
+  {
+    return AstQueryNamespace::queryMemoryPoolInParallel(nodeFunc,targetVariantVector,numberOfThreads);
+  }
+
+  ROSE_DLL_API DefaultNodeFunctional::result_type
+  queryMemoryPoolInParallel(VariantVector& targetVariantVector, size_t numberOfThreads = 0);
+
+
 // END NAMESPACE NodeQuery2
 }
 
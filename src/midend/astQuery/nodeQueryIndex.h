@@ -0,0 +1,128 @@
+#ifndef ROSE_NODE_QUERY_INDEX
+#define ROSE_NODE_QUERY_INDEX
+
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rosedll.h"
+#include "astQuery.h"
+
+namespace NodeQuery
+{
+/*! \brief Variant indexed answers to NodeQuery::querySubTree() for the AST of a source file.
+
+    Every node of the AST of the file gets two labels, one before and one after its subtree in
+    preorder (enter < labels of all descendants < exit), and for each variant the index keeps the
+    nodes of that variant sorted by their enter label.  The nodes of a given variant in the subtree
+    of a node n are those with an enter label in [enter(n),exit(n)), so querySubTree(n,V_SgXxx) is
+    answered by a binary search instead of a traversal of the subtree (the result is in preorder,
+    as for the traversal).  Queries for type variants (which querySubTree() also collects from
+    outside the traversed tree) and queries other than AstQueryNamespace::AllNodes still traverse
+    the subtree.
+
+    The index is optional, build() enables it for a file.  It is kept current by the SageInterface
+    functions inserting, moving, replacing and removing statements and expressions and by
+    SageInterface::deleteAST(), which call subtreeInserted(), subtreeChanged() and subtreeRemoved().
+    The nodes of an inserted subtree get labels in the gap between the labels of their new
+    neighbours; when the gap is too small, or the inserted subtree is not found below its parent,
+    the index is rebuilt by the next query.  The other SageInterface functions changing the AST
+    (e.g. the loop transformations) hold an Invalidation while they run, the indexes are then
+    rebuilt by the next query.
+
+    \note Changes made to the AST without using SageInterface (e.g. setting a child pointer
+          directly) are not seen by the index, so only build the index for files transformed by
+          SageInterface.  verify() compares the index with a traversal of the file.
+ */
+  class ROSE_DLL_API QueryIndex
+  {
+    public:
+      //! Builds (or rebuilds) the index of the file, querySubTree() uses it from now on.
+      static QueryIndex* build (SgSourceFile* file);
+
+      //! Removes the index of the file (or of all files).
+      static void drop (SgSourceFile* file);
+      static void dropAll ();
+
+      //! Returns the index holding node, or NULL.
+      static QueryIndex* lookup (SgNode* node);
+
+      //! Hook called after subtree was inserted into the AST (or moved within the AST).
+      static void subtreeInserted (SgNode* subtree);
+
+      //! Hook called when subtree is removed from the AST, before its nodes are deleted.
+      static void subtreeRemoved (SgNode* subtree);
+
+      //! Hook called after children of subtree were set (in place of the previous ones), its nodes get new labels.
+      static void subtreeChanged (SgNode* subtree);
+
+      /*! \brief Held by a function changing the AST without calling the hooks.
+
+          While an Invalidation exists querySubTree() traverses the AST and the hooks do nothing, the
+          indexes are rebuilt by the first query after the last Invalidation is destroyed.
+       */
+      class ROSE_DLL_API Invalidation
+      {
+        public:
+          Invalidation ();
+          ~Invalidation ();
+
+          Invalidation (const Invalidation &) = delete;
+          Invalidation & operator= (const Invalidation &) = delete;
+      };
+
+      /*! \brief Answers querySubTree(subTree,variants) from the index of the file holding subTree.
+
+          Returns false (and leaves result unchanged) if there is no such index or if the query
+          needs a traversal (e.g. for type variants).
+       */
+      static bool querySubTree (SgNode* subTree, const VariantVector & variants, Rose_STL_Container<SgNode*> & result);
+
+      //! Returns true if the index matches a traversal of the file (rebuilds the index first if it is out of date).
+      bool verify ();
+
+      SgSourceFile* get_file () const { return p_file; }
+
+      //! Number of nodes in the index.
+      size_t size () const { return p_labels.size(); }
+
+      //! Number of times the index was built from a traversal of the file.
+      size_t numberOfRebuilds () const { return p_numberOfRebuilds; }
+
+    private:
+      struct Labels
+      {
+        uint64_t enter;
+        uint64_t exit;
+      };
+
+      typedef std::vector<std::pair<uint64_t,SgNode*> > NodeList;
+
+      QueryIndex (SgSourceFile* file);
+
+      void rebuild ();
+      void insert (SgNode* subtree);
+      void remove (SgNode* subtree);
+      void relabel (SgNode* subtree);
+      void eraseNodesOf (SgNode* subtree);
+      bool assignLabels (SgNode* subtree, uint64_t lower, uint64_t upper);
+      void eraseNode (SgNode* node);
+
+      SgSourceFile* p_file;
+      bool p_valid;
+      size_t p_numberOfRebuilds;
+
+      std::unordered_map<SgNode*,Labels> p_labels;
+
+   // Indexed by variant, sorted by enter label.
+      std::vector<NodeList> p_nodesByVariant;
+
+      static std::vector<QueryIndex*> indexes;
+
+   // Number of Invalidation objects.
+      static size_t invalidations;
+  };
+}
+
+#endif
@@ -4,6 +4,7 @@
 #include "astQuery.h"
 #include "booleanQuery.h"
 #include "nodeQuery.h"
+#include "nodeQueryIndex.h"
 #include "nameQuery.h"
 #include "numberQuery.h"
 /* include "projectQuery.h" */
@@ -759,12 +759,16 @@ SgStatement *getOmpParent(SgStatement *node) {
   return NULL;
 }
 
-// traverse the SgNode AST and fill the information of OpenMP executable
-// directive parent and children.
-void createOmpStatementTree(SgSourceFile *file) {
-  Rose_STL_Container<SgNode *> node_list =
-      NodeQuery::querySubTree(file, V_SgOmpExecStatement);
-  Rose_STL_Container<SgNode *>::reverse_iterator node_list_iterator;
+// fill the information of OpenMP executable directive parent and children of
+// the given nodes, in preorder. The children found before are discarded.
+void createOmpStatementTree(const Rose_STL_Container<SgNode *> &node_list) {
+  Rose_STL_Container<SgNode *>::const_iterator iter;
+  for (iter = node_list.begin(); iter != node_list.end(); iter++) {
+    SgOmpExecStatement *node = isSgOmpExecStatement(*iter);
+    ROSE_ASSERT(node != NULL);
+    node->get_omp_children().clear();
+  }
+  Rose_STL_Container<SgNode *>::const_reverse_iterator node_list_iterator;
   for (node_list_iterator = node_list.rbegin();
        node_list_iterator != node_list.rend(); node_list_iterator++) {
     SgOmpExecStatement *node = isSgOmpExecStatement(*node_list_iterator);
@@ -777,6 +781,12 @@ void createOmpStatementTree(SgSourceFile *file) {
   }
 }
 
+// traverse the SgNode AST and fill the information of OpenMP executable
+// directive parent and children.
+void createOmpStatementTree(SgSourceFile *file) {
+  createOmpStatementTree(NodeQuery::querySubTree(file, V_SgOmpExecStatement));
+}
+
 void setOmpNumTeams(SgNode *node) {
   ROSE_ASSERT(node != NULL);
   SgOmpClauseBodyStatement *target = isSgOmpClauseBodyStatement(node);
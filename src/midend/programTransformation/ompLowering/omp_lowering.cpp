@@ -4,6 +4,10 @@
 #include "Outliner.hh"
 #include "omp_lowering.h"
 #include "RoseAst.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
 #include <sstream>
 #include "rex_llvm.h"
 
@@ -71,6 +75,10 @@ static SgSourceFile *generate_outlined_function_file(SgFunctionDeclaration *,
                                                      std::string);
 static void fix_storage_modifier(SgSourceFile *);
 static unsigned int kmpc_global_tid_counter = 0;
+// the reduce functions generated by buildReduceFunction(), by name, so that
+// move_outlined_function() can move them with the outlined functions using them
+static std::map<string, SgFunctionDeclaration *> reduction_functions;
+static unsigned int reduction_function_counter = 0;
 static unsigned int kmpc_kernel_id_counter = 0;
 
 static SgSourceFile *cpu_outlined_file = NULL;
@@ -104,6 +112,10 @@ bool enable_debugging = false;   /* default is not to debug the process */
 // data allocation, copy, free functions.
 bool useDDE = true;
 
+// A flag to schedule static loops in the generated code instead of calling the
+// runtime (see insertOmpInlineStaticSchedule()).
+bool inline_static_schedule = false;
+
 unsigned int nCounter = 0;
 //------------------------------------
 // Add include "xxxx.h" into source files, right before the first statement from
@@ -943,6 +955,22 @@ bool useStaticSchedule(SgOmpClauseBodyStatement *omp_loop) {
   return result;
 }
 
+//! check if an omp for loop can be scheduled in the generated code
+//! (-rose:openmp:inline_static_schedule): static schedule without a chunk size
+//! and without ordered
+static bool useInlineStaticSchedule(SgOmpClauseBodyStatement *omp_loop) {
+  ROSE_ASSERT(omp_loop);
+  if (!inline_static_schedule || !useStaticSchedule(omp_loop) ||
+      hasClause(omp_loop, V_SgOmpOrderedClause))
+    return false;
+  Rose_STL_Container<SgOmpClause *> clauses =
+      getClause(omp_loop, V_SgOmpScheduleClause);
+  if (clauses.size() != 0 &&
+      isSgOmpScheduleClause(clauses[0])->get_chunk_size() != NULL)
+    return false;
+  return true;
+}
+
 // Chunk size  for dynamic and guided schedule should be 1 if not specified.
 static SgExpression *createAdjustedChunkSize(SgExpression *orig_chunk_size) {
   SgExpression *result = NULL;
@@ -1076,6 +1104,42 @@ static void insert_libxompf_h(SgNode *startNode) {
       prependStatement(s_include, t_body);
   }
 }
+
+//! The suffix of the runtime's loop scheduling functions for a canonical loop
+//! ("_4", "_4u", "_8" or "_8u"): 64-bit if the loop index or a bound has a
+//! 64-bit type, unsigned if the loop index is unsigned.
+static string getKmpLoopSuffix(SgInitializedName *orig_index,
+                               SgExpression *orig_lower,
+                               SgExpression *orig_upper) {
+  SgType *types[3] = {orig_index->get_type(), orig_lower->get_type(),
+                      orig_upper->get_type()};
+  bool is_64bit = false;
+  for (int i = 0; i < 3; i++) {
+    SgType *type = types[i]->stripTypedefsAndModifiers();
+    if (isSgTypeLong(type) || isSgTypeSignedLong(type) ||
+        isSgTypeUnsignedLong(type) || isSgTypeLongLong(type) ||
+        isSgTypeSignedLongLong(type) || isSgTypeUnsignedLongLong(type))
+      is_64bit = true;
+  }
+  SgType *index_type = types[0]->stripTypedefsAndModifiers();
+  bool is_unsigned =
+      isSgTypeUnsignedInt(index_type) || isSgTypeUnsignedLong(index_type) ||
+      isSgTypeUnsignedLongLong(index_type) ||
+      isSgTypeUnsignedShort(index_type) || isSgTypeUnsignedChar(index_type);
+  return string(is_64bit ? "_8" : "_4") + (is_unsigned ? "u" : "");
+}
+
+//! The type of the loop bounds (or of the stride, which is signed) passed to the
+//! runtime's loop scheduling functions with the suffix
+static SgType *buildKmpLoopType(const string &suffix, bool is_stride,
+                                SgScopeStatement *scope) {
+  bool is_unsigned = !is_stride && suffix[suffix.size() - 1] == 'u';
+  if (suffix.compare(0, 2, "_8") == 0)
+    return buildOpaqueType(is_unsigned ? "uint64_t" : "int64_t", scope);
+  return is_unsigned ? (SgType *)buildUnsignedIntType()
+                     : (SgType *)buildIntType();
+}
+
 //! Translate an omp for loop with non-static scheduling clause or with ordered
 //! clause ()
 // bb1 is the basic block to insert the translated loop
@@ -1180,6 +1244,7 @@ static void transOmpLoop_others(SgOmpClauseBodyStatement *target,
     ROSE_ASSERT(false);
   }
   ROSE_ASSERT(is_canonical == true);
+  string kmp_suffix = getKmpLoopSuffix(orig_index, orig_lower, orig_upper);
 
   Rose_STL_Container<SgOmpClause *> clauses =
       getClause(target, V_SgOmpScheduleClause);
@@ -1189,7 +1254,7 @@ static void transOmpLoop_others(SgOmpClauseBodyStatement *target,
   SgOmpClause::omp_schedule_kind_enum s_kind =
       SgOmpClause::e_omp_schedule_kind_static;
   SgExpression *orig_chunk_size = NULL;
-  string func_init_name = "__kmpc_for_static_init_4";
+  string func_init_name = "__kmpc_for_static_init" + kmp_suffix;
   int32_t schedule_type = 0;
   bool hasOrder = false;
   if (hasClause(target, V_SgOmpOrderedClause))
@@ -1216,7 +1281,7 @@ static void transOmpLoop_others(SgOmpClauseBodyStatement *target,
     if (s_kind == SgOmpClause::e_omp_schedule_kind_dynamic ||
         s_kind == SgOmpClause::e_omp_schedule_kind_guided) {
       orig_chunk_size = createAdjustedChunkSize(orig_chunk_size);
-      func_init_name = "__kmpc_dispatch_init_4";
+      func_init_name = "__kmpc_dispatch_init" + kmp_suffix;
       if (s_kind == SgOmpClause::e_omp_schedule_kind_dynamic) {
         schedule_type += kmp_sched_dynamic;
       } else {
@@ -1230,7 +1295,7 @@ static void transOmpLoop_others(SgOmpClauseBodyStatement *target,
     } else if (s_kind == SgOmpClause::e_omp_schedule_kind_auto ||
                s_kind == SgOmpClause::e_omp_schedule_kind_runtime) {
       orig_chunk_size = buildIntVal(1);
-      func_init_name = "__kmpc_dispatch_init_4";
+      func_init_name = "__kmpc_dispatch_init" + kmp_suffix;
       if (s_kind == SgOmpClause::e_omp_schedule_kind_auto) {
         schedule_type += kmp_sched_auto;
       } else {
@@ -1242,7 +1307,9 @@ static void transOmpLoop_others(SgOmpClauseBodyStatement *target,
           buildVarRefExp(stride_decl), orig_chunk_size);
 
     } else {
-      schedule_type += kmp_sched_static_chunk;
+      // __kmpc_for_static_init does not take the schedule modifiers (only the
+      // dispatch calls strip them)
+      schedule_type = kmp_sched_static_chunk;
       parameters = buildExprListExp(
           source_location_info, thread_global_tid, buildIntVal(schedule_type),
           buildAddressOfOp(buildVarRefExp(last_iter_decl)),
@@ -1329,7 +1396,7 @@ static void transOmpLoop_others(SgOmpClauseBodyStatement *target,
                            buildAddressOfOp(buildVarRefExp(lower_decl)),
                            buildAddressOfOp(buildVarRefExp(upper_decl)),
                            buildAddressOfOp(buildVarRefExp(stride_decl)));
-      func_next_exp = buildFunctionCallExp("__kmpc_dispatch_next_4",
+      func_next_exp = buildFunctionCallExp("__kmpc_dispatch_next" + kmp_suffix,
                                            buildIntType(), parameters, bb1);
     } else { // for schedule(static, n), lower_bound <= upper_bound controls the
              // while loop
@@ -1425,6 +1492,127 @@ static void transOmpLoop_others(SgOmpClauseBodyStatement *target,
   }
 }
 
+//! Schedule the iterations of a loop with the static schedule in the generated
+//! code, without calling the runtime: each thread gets one contiguous block of
+//! iterations, and the first (iteration count % thread count) threads one
+//! more iteration, as in XOMP_static_even_divide(). The loop bounds are the
+//! normalized (inclusive) ones in __lower_ and __upper_.
+/*
+  int __num_threads_ = omp_get_num_threads();
+  int __thread_id_ = omp_get_thread_num();
+  if (__lower_ <= __upper_) {
+    int __iter_count_ = (__upper_ - __lower_) / __stride_ + 1;
+    int __chunk_size_ = __iter_count_ / __num_threads_;
+    int __chunk_remainder_ = __iter_count_ % __num_threads_;
+    int __chunk_offset_ = __chunk_size_ * __thread_id_ + __chunk_remainder_;
+    if (__thread_id_ < __chunk_remainder_) {
+      __chunk_size_ += 1;
+      __chunk_offset_ = __chunk_size_ * __thread_id_;
+    }
+    __lower_ += __chunk_offset_ * __stride_;
+    __upper_ = __lower_ + (__chunk_size_ - 1) * __stride_;
+  }
+*/
+// Decremental loops compare with >= and count (__lower_ - __upper_) /
+// -__stride_ + 1 iterations. A thread without iterations gets an empty block
+// right after the last iteration.
+static void insertOmpInlineStaticSchedule(SgVariableDeclaration *lower_decl,
+                                          SgVariableDeclaration *upper_decl,
+                                          SgVariableDeclaration *stride_decl,
+                                          bool isIncremental,
+                                          SgBasicBlock *bb1) {
+  SgType *bound_type = getFirstVariable(*lower_decl).get_type();
+
+  SgVariableDeclaration *num_threads_decl = buildVariableDeclaration(
+      "__num_threads_", buildIntType(),
+      buildAssignInitializer(buildFunctionCallExp(
+          "omp_get_num_threads", buildIntType(), buildExprListExp(), bb1)),
+      bb1);
+  appendStatement(num_threads_decl, bb1);
+  SgVariableDeclaration *thread_id_decl = buildVariableDeclaration(
+      "__thread_id_", buildIntType(),
+      buildAssignInitializer(buildFunctionCallExp(
+          "omp_get_thread_num", buildIntType(), buildExprListExp(), bb1)),
+      bb1);
+  appendStatement(thread_id_decl, bb1);
+
+  SgBasicBlock *true_body = buildBasicBlock();
+  SgExpression *if_condition = NULL;
+  SgExpression *distance = NULL;
+  if (isIncremental) {
+    if_condition = buildLessOrEqualOp(buildVarRefExp(lower_decl),
+                                      buildVarRefExp(upper_decl));
+    distance = buildDivideOp(
+        buildSubtractOp(buildVarRefExp(upper_decl), buildVarRefExp(lower_decl)),
+        buildVarRefExp(stride_decl));
+  } else {
+    if_condition = buildGreaterOrEqualOp(buildVarRefExp(lower_decl),
+                                         buildVarRefExp(upper_decl));
+    distance = buildDivideOp(
+        buildSubtractOp(buildVarRefExp(lower_decl), buildVarRefExp(upper_decl)),
+        buildMinusOp(buildVarRefExp(stride_decl)));
+  }
+  SgIfStmt *if_stmt = buildIfStmt(if_condition, true_body, NULL);
+  appendStatement(if_stmt, bb1);
+
+  SgVariableDeclaration *iter_count_decl = buildVariableDeclaration(
+      "__iter_count_", bound_type,
+      buildAssignInitializer(buildAddOp(distance, buildIntVal(1))), true_body);
+  appendStatement(iter_count_decl, true_body);
+  SgVariableDeclaration *chunk_size_decl = buildVariableDeclaration(
+      "__chunk_size_", bound_type,
+      buildAssignInitializer(buildDivideOp(buildVarRefExp(iter_count_decl),
+                                           buildVarRefExp(num_threads_decl))),
+      true_body);
+  appendStatement(chunk_size_decl, true_body);
+  SgVariableDeclaration *remainder_decl = buildVariableDeclaration(
+      "__chunk_remainder_", bound_type,
+      buildAssignInitializer(buildModOp(buildVarRefExp(iter_count_decl),
+                                        buildVarRefExp(num_threads_decl))),
+      true_body);
+  appendStatement(remainder_decl, true_body);
+  SgVariableDeclaration *offset_decl = buildVariableDeclaration(
+      "__chunk_offset_", bound_type,
+      buildAssignInitializer(
+          buildAddOp(buildMultiplyOp(buildVarRefExp(chunk_size_decl),
+                                     buildVarRefExp(thread_id_decl)),
+                     buildVarRefExp(remainder_decl))),
+      true_body);
+  appendStatement(offset_decl, true_body);
+
+  // the first __chunk_remainder_ threads get one more iteration
+  SgBasicBlock *extra_body = buildBasicBlock();
+  appendStatement(buildExprStatement(buildPlusAssignOp(
+                      buildVarRefExp(chunk_size_decl), buildIntVal(1))),
+                  extra_body);
+  appendStatement(
+      buildAssignStatement(buildVarRefExp(offset_decl),
+                           buildMultiplyOp(buildVarRefExp(chunk_size_decl),
+                                           buildVarRefExp(thread_id_decl))),
+      extra_body);
+  appendStatement(
+      buildIfStmt(buildLessThanOp(buildVarRefExp(thread_id_decl),
+                                  buildVarRefExp(remainder_decl)),
+                  extra_body, NULL),
+      true_body);
+
+  appendStatement(
+      buildExprStatement(buildPlusAssignOp(
+          buildVarRefExp(lower_decl),
+          buildMultiplyOp(buildVarRefExp(offset_decl),
+                          buildVarRefExp(stride_decl)))),
+      true_body);
+  appendStatement(
+      buildAssignStatement(
+          buildVarRefExp(upper_decl),
+          buildAddOp(buildVarRefExp(lower_decl),
+                     buildMultiplyOp(
+                         buildSubtractOp(buildVarRefExp(chunk_size_decl),
+                                         buildIntVal(1)),
+                         buildVarRefExp(stride_decl)))),
+      true_body);
+}
+
 // Expected AST
 // * OmpForStatement
 // ** SgForStatement
@@ -1536,6 +1724,9 @@ void transOmpLoop(SgNode *node) {
         isCanonicalDoLoop(do_loop, &orig_index, &orig_lower, &orig_upper,
                           &orig_stride, NULL, &isIncremental, NULL);
   ROSE_ASSERT(is_canonical == true);
+  string kmp_suffix = getKmpLoopSuffix(orig_index, orig_lower, orig_upper);
+  // static schedule computed in the generated code (C/C++ only)
+  bool inline_schedule = for_loop != NULL && useInlineStaticSchedule(target);
 
   // step 2. Insert a basic block to replace OmpForStatement
   // This newly introduced scope is used to hold loop variables, private
@@ -1580,23 +1771,30 @@ void transOmpLoop(SgNode *node) {
         "p_upper_" + StringUtility::numberToString(nCounter), loop_var_type,
         NULL, bb1);
   } else {
-    index_decl =
-        buildVariableDeclaration("__index_", buildIntType(), NULL, bb1);
+    // the loop control variables have the width and signedness of the
+    // runtime calls scheduling the loop
+    SgType *bound_type = buildKmpLoopType(kmp_suffix, false, bb1);
+    SgType *stride_type = buildKmpLoopType(kmp_suffix, true, bb1);
+    index_decl = buildVariableDeclaration("__index_", bound_type, NULL, bb1);
     lower_decl = buildVariableDeclaration(
-        "__lower_", buildIntType(), buildAssignInitializer(orig_lower), bb1);
+        "__lower_", bound_type, buildAssignInitializer(orig_lower), bb1);
     upper_decl = buildVariableDeclaration(
-        "__upper_", buildIntType(), buildAssignInitializer(orig_upper), bb1);
+        "__upper_", bound_type, buildAssignInitializer(orig_upper), bb1);
     stride_decl = buildVariableDeclaration(
-        "__stride_", buildIntType(), buildAssignInitializer(orig_stride), bb1);
-    last_iter_decl =
-        buildVariableDeclaration("__last_iter_", buildIntType(),
-                                 buildAssignInitializer(buildIntVal(0)), bb1);
+        "__stride_", stride_type, buildAssignInitializer(orig_stride), bb1);
 
     appendStatement(index_decl, bb1);
     appendStatement(lower_decl, bb1);
     appendStatement(upper_decl, bb1);
     appendStatement(stride_decl, bb1);
-    appendStatement(last_iter_decl, bb1);
+    // only the runtime calls report the last iteration, the inline schedule
+    // does not need the variable (nor its symbol in bb1)
+    if (!inline_schedule) {
+      last_iter_decl =
+          buildVariableDeclaration("__last_iter_", buildIntType(),
+                                   buildAssignInitializer(buildIntVal(0)), bb1);
+      appendStatement(last_iter_decl, bb1);
+    }
   }
 
   bool hasOrder = false;
@@ -1622,7 +1820,35 @@ void transOmpLoop(SgNode *node) {
   }
 
   //  step 3. Translation for omp for
-  if (!useStaticSchedule(target) || hasOrder || hasSpecifiedSize) {
+  if (inline_schedule) {
+    insertOmpInlineStaticSchedule(lower_decl, upper_decl, stride_decl,
+                                  isIncremental, bb1);
+
+    // add loop here, over the contiguous block of iterations of the thread
+    SgStatement *new_loop = deepCopy(loop);
+    appendStatement(new_loop, bb1);
+    replaceVariableReferences(
+        new_loop,
+        isSgVariableSymbol(orig_index->get_symbol_from_symbol_table()),
+        getFirstVarSym(index_decl));
+    SageInterface::setLoopLowerBound(new_loop, buildVarRefExp(lower_decl));
+    SageInterface::setLoopUpperBound(new_loop, buildVarRefExp(upper_decl));
+
+    transOmpVariables(
+        target, bb1,
+        orig_upper); // This should happen before the barrier is inserted.
+    // insert barrier if there is no nowait clause, the only runtime call left
+    if (!hasClause(target, V_SgOmpNowaitClause)) {
+      SgVariableDeclaration *kmpc_global_tid_declaration =
+          get_kmpc_global_tid(node, bb1);
+      appendStatement(kmpc_global_tid_declaration, bb1);
+      parameters = buildExprListExp(
+          buildIntVal(0), buildVarRefExp(kmpc_global_tid_declaration));
+      appendStatement(buildFunctionCallStmt("__kmpc_barrier", buildVoidType(),
+                                            parameters, bb1),
+                      bb1);
+    }
+  } else if (!useStaticSchedule(target) || hasOrder || hasSpecifiedSize) {
     transOmpLoop_others(target, index_decl, lower_decl, upper_decl, stride_decl,
                         last_iter_decl, bb1);
   } else {
@@ -1658,7 +1884,8 @@ void transOmpLoop(SgNode *node) {
                          e5, buildAddressOfOp(buildVarRefExp(stride_decl)),
                          copyExpression(orig_stride), buildIntVal(1));
     SgStatement *call_stmt = buildFunctionCallStmt(
-        "__kmpc_for_static_init_4", buildVoidType(), parameters, bb1);
+        "__kmpc_for_static_init" + kmp_suffix, buildVoidType(), parameters,
+        bb1);
     appendStatement(call_stmt, bb1);
 
     // insert the upper bound checking
@@ -5317,14 +5544,292 @@ void transOmpSections(SgNode *node) {
   //    removeStatement(target);
 }
 
+// Lock-free atomic updates  x = x op value  (op: + - * / & | ^ << >> && ||)
+// used instead of the update between __kmpc_atomic_start() and
+// __kmpc_atomic_end(), which is one lock shared by all of the atomic updates of
+// the program:
+// 1. integer x and value, + - & | ^: a builtin function
+//    __atomic_fetch_add(&x, value, __ATOMIC_RELAXED);
+// 2. long double x, + - * /: the atomic entry point of the runtime
+//    __kmpc_atomic_float10_add(0, __kmpc_global_thread_num(0), &x, value);
+// 3. other integer x, float and double x: a compare-and-swap loop
+//    {
+//      int __rex_atomic_value = value;
+//      double __rex_atomic_old;
+//      double __rex_atomic_new;
+//      __atomic_load(&x, &__rex_atomic_old, __ATOMIC_RELAXED);
+//      do
+//        __rex_atomic_new = __rex_atomic_old op __rex_atomic_value;
+//      while (!__atomic_compare_exchange(&x, &__rex_atomic_old,
+//                                        &__rex_atomic_new, 0,
+//                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+//    }
+// Other types (complex, pointers, structures) and Fortran keep the lock.
+
+//! The address of an lvalue, without &* for the variables already replaced by
+//! a dereference of their address
+static SgExpression *buildAtomicAddress(SgExpression *lhs) {
+  if (SgPointerDerefExp *deref = isSgPointerDerefExp(lhs))
+    return deepCopy(deref->get_operand());
+  return buildAddressOfOp(deepCopy(lhs));
+}
+
+static SgExpression *buildAtomicOperation(VariantT op, SgExpression *lhs,
+                                          SgExpression *rhs) {
+  switch (op) {
+  case V_SgAddOp:
+    return buildAddOp(lhs, rhs);
+  case V_SgSubtractOp:
+    return buildSubtractOp(lhs, rhs);
+  case V_SgMultiplyOp:
+    return buildMultiplyOp(lhs, rhs);
+  case V_SgDivideOp:
+    return buildDivideOp(lhs, rhs);
+  case V_SgBitAndOp:
+    return buildBitAndOp(lhs, rhs);
+  case V_SgBitOrOp:
+    return buildBitOrOp(lhs, rhs);
+  case V_SgBitXorOp:
+    return buildBitXorOp(lhs, rhs);
+  case V_SgLshiftOp:
+    return buildLshiftOp(lhs, rhs);
+  case V_SgRshiftOp:
+    return buildRshiftOp(lhs, rhs);
+  case V_SgAndOp:
+    return buildAndOp(lhs, rhs);
+  case V_SgOrOp:
+    return buildOrOp(lhs, rhs);
+  default:
+    cerr << "Illegal atomic update operator:" << op << endl;
+    ROSE_ASSERT(false);
+  }
+  return NULL;
+}
+
+//! Build the lock-free statement for the atomic update
+//!   lhs = lhs op value  (or  lhs = value op lhs  if value_first is true)
+//! using copies of lhs and value. Returns NULL if the update has to use the
+//! lock.
+static SgStatement *buildNativeAtomicUpdate(SgExpression *lhs, VariantT op,
+                                            SgExpression *value,
+                                            bool value_first,
+                                            const string &memory_order,
+                                            SgScopeStatement *scope) {
+  ROSE_ASSERT(lhs != NULL);
+  ROSE_ASSERT(value != NULL);
+  ROSE_ASSERT(scope != NULL);
+  if (SageInterface::is_Fortran_language())
+    return NULL;
+
+  SgType *type = lhs->get_type()->stripTypedefsAndModifiers();
+  SgType *value_type = value->get_type()->stripTypedefsAndModifiers();
+  bool is_integer = isStrictIntegerType(type) || isSgTypeChar(type) ||
+                    isSgTypeSignedChar(type) || isSgTypeUnsignedChar(type);
+  bool is_commutative = op == V_SgAddOp || op == V_SgBitAndOp ||
+                        op == V_SgBitOrOp || op == V_SgBitXorOp;
+
+  // 1. __atomic_fetch_<op>
+  if (is_integer && isStrictIntegerType(value_type) &&
+      (is_commutative || (op == V_SgSubtractOp && !value_first))) {
+    string name;
+    switch (op) {
+    case V_SgAddOp:
+      name = "__atomic_fetch_add";
+      break;
+    case V_SgSubtractOp:
+      name = "__atomic_fetch_sub";
+      break;
+    case V_SgBitAndOp:
+      name = "__atomic_fetch_and";
+      break;
+    case V_SgBitOrOp:
+      name = "__atomic_fetch_or";
+      break;
+    default:
+      name = "__atomic_fetch_xor";
+      break;
+    }
+    SgExprListExp *parameters =
+        buildExprListExp(buildAtomicAddress(lhs), deepCopy(value),
+                         buildOpaqueVarRefExp(memory_order, scope));
+    return buildFunctionCallStmt(name, type, parameters, scope);
+  }
+
+  // 2. __kmpc_atomic_float10_<op>
+  if (isSgTypeLongDouble(type) && !value_first &&
+      (op == V_SgAddOp || op == V_SgSubtractOp || op == V_SgMultiplyOp ||
+       op == V_SgDivideOp)) {
+    string name = op == V_SgAddOp        ? "__kmpc_atomic_float10_add"
+                  : op == V_SgSubtractOp ? "__kmpc_atomic_float10_sub"
+                  : op == V_SgMultiplyOp ? "__kmpc_atomic_float10_mul"
+                                         : "__kmpc_atomic_float10_div";
+    SgExpression *global_tid =
+        buildFunctionCallExp("__kmpc_global_thread_num", buildIntType(),
+                             buildExprListExp(buildIntVal(0)), scope);
+    SgExprListExp *parameters =
+        buildExprListExp(buildIntVal(0), global_tid, buildAtomicAddress(lhs),
+                         deepCopy(value));
+    return buildFunctionCallStmt(name, buildVoidType(), parameters, scope);
+  }
+
+  // 3. compare-and-swap loop
+  if (!is_integer && !isSgTypeFloat(type) && !isSgTypeDouble(type))
+    return NULL;
+  if (!isScalarType(value_type))
+    return NULL;
+
+  SgBasicBlock *bb = buildBasicBlock();
+  bb->set_parent(scope);
+  SgVariableDeclaration *value_decl =
+      buildVariableDeclaration("__rex_atomic_value", value_type,
+                               buildAssignInitializer(deepCopy(value)), bb);
+  SgVariableDeclaration *old_decl =
+      buildVariableDeclaration("__rex_atomic_old", type, NULL, bb);
+  SgVariableDeclaration *new_decl =
+      buildVariableDeclaration("__rex_atomic_new", type, NULL, bb);
+  appendStatement(value_decl, bb);
+  appendStatement(old_decl, bb);
+  appendStatement(new_decl, bb);
+
+  SgExprListExp *load_parameters = buildExprListExp(
+      buildAtomicAddress(lhs), buildAddressOfOp(buildVarRefExp(old_decl)),
+      buildOpaqueVarRefExp("__ATOMIC_RELAXED", bb));
+  appendStatement(buildFunctionCallStmt("__atomic_load", buildVoidType(),
+                                        load_parameters, bb),
+                  bb);
+
+  SgExpression *new_value =
+      value_first ? buildAtomicOperation(op, buildVarRefExp(value_decl),
+                                         buildVarRefExp(old_decl))
+                  : buildAtomicOperation(op, buildVarRefExp(old_decl),
+                                         buildVarRefExp(value_decl));
+  SgStatement *loop_body =
+      buildAssignStatement(buildVarRefExp(new_decl), new_value);
+  SgExprListExp *cas_parameters = buildExprListExp(
+      buildAtomicAddress(lhs), buildAddressOfOp(buildVarRefExp(old_decl)),
+      buildAddressOfOp(buildVarRefExp(new_decl)), buildIntVal(0),
+      buildOpaqueVarRefExp(memory_order, bb),
+      buildOpaqueVarRefExp("__ATOMIC_RELAXED", bb));
+  SgExpression *cas = buildFunctionCallExp(
+      "__atomic_compare_exchange", buildBoolType(), cas_parameters, bb);
+  appendStatement(buildDoWhileStmt(loop_body, buildNotOp(cas)), bb);
+  return bb;
+}
+
+//! Build the lock-free statement for the update of an omp atomic directive
+//! (x++, x op= value, x = x op value, x = value op x), or NULL if it has to use
+//! the lock
+static SgStatement *buildNativeAtomicStatement(SgOmpAtomicStatement *target,
+                                               SgStatement *body,
+                                               SgScopeStatement *scope) {
+  // read, write and capture are not updates
+  if (hasClause(target, V_SgOmpReadClause) ||
+      hasClause(target, V_SgOmpWriteClause) ||
+      hasClause(target, V_SgOmpCaptureClause))
+    return NULL;
+
+  string memory_order = "__ATOMIC_RELAXED";
+  if (hasClause(target, V_SgOmpSeqCstClause))
+    memory_order = "__ATOMIC_SEQ_CST";
+  else if (hasClause(target, V_SgOmpAcqRelClause))
+    memory_order = "__ATOMIC_ACQ_REL";
+  else if (hasClause(target, V_SgOmpReleaseClause))
+    memory_order = "__ATOMIC_RELEASE";
+  else if (hasClause(target, V_SgOmpAcquireClause))
+    memory_order = "__ATOMIC_ACQUIRE";
+
+  SgExprStatement *expr_stmt = isSgExprStatement(body);
+  if (expr_stmt == NULL)
+    return NULL;
+  SgExpression *exp = expr_stmt->get_expression();
+
+  if (isSgPlusPlusOp(exp) || isSgMinusMinusOp(exp)) {
+    SgExpression *operand = isSgUnaryOp(exp)->get_operand();
+    return buildNativeAtomicUpdate(
+        operand, isSgPlusPlusOp(exp) ? V_SgAddOp : V_SgSubtractOp,
+        buildIntVal(1), false, memory_order, scope);
+  }
+
+  SgBinaryOp *bin_op = isSgBinaryOp(exp);
+  if (bin_op == NULL)
+    return NULL;
+  SgExpression *lhs = bin_op->get_lhs_operand();
+  SgExpression *rhs = bin_op->get_rhs_operand();
+
+  VariantT op = V_SgNode;
+  switch (exp->variantT()) {
+  case V_SgPlusAssignOp:
+    op = V_SgAddOp;
+    break;
+  case V_SgMinusAssignOp:
+    op = V_SgSubtractOp;
+    break;
+  case V_SgMultAssignOp:
+    op = V_SgMultiplyOp;
+    break;
+  case V_SgDivAssignOp:
+    op = V_SgDivideOp;
+    break;
+  case V_SgAndAssignOp:
+    op = V_SgBitAndOp;
+    break;
+  case V_SgIorAssignOp:
+    op = V_SgBitOrOp;
+    break;
+  case V_SgXorAssignOp:
+    op = V_SgBitXorOp;
+    break;
+  case V_SgLshiftAssignOp:
+    op = V_SgLshiftOp;
+    break;
+  case V_SgRshiftAssignOp:
+    op = V_SgRshiftOp;
+    break;
+  case V_SgAssignOp: {
+    // x = x op value, x = value op x
+    SgBinaryOp *rhs_op = isSgBinaryOp(rhs);
+    if (rhs_op == NULL)
+      return NULL;
+    switch (rhs_op->variantT()) {
+    case V_SgAddOp:
+    case V_SgSubtractOp:
+    case V_SgMultiplyOp:
+    case V_SgDivideOp:
+    case V_SgBitAndOp:
+    case V_SgBitOrOp:
+    case V_SgBitXorOp:
+    case V_SgLshiftOp:
+    case V_SgRshiftOp:
+    case V_SgAndOp:
+    case V_SgOrOp:
+      break;
+    default:
+      return NULL;
+    }
+    string x = lhs->unparseToString();
+    if (rhs_op->get_lhs_operand()->unparseToString() == x)
+      return buildNativeAtomicUpdate(lhs, rhs_op->variantT(),
+                                     rhs_op->get_rhs_operand(), false,
+                                     memory_order, scope);
+    if (rhs_op->get_rhs_operand()->unparseToString() == x)
+      return buildNativeAtomicUpdate(lhs, rhs_op->variantT(),
+                                     rhs_op->get_lhs_operand(), true,
+                                     memory_order, scope);
+    return NULL;
+  }
+  default:
+    return NULL;
+  }
+  return buildNativeAtomicUpdate(lhs, op, rhs, false, memory_order, scope);
+}
+
 // Two ways
-// 1. builtin function TODO
-//    __sync_fetch_and_add_4(&shared, (unsigned int)local);
-// 2. using atomic runtime call:
-//    GOMP_atomic_start (); // void GOMP_atomic_start (void);
+// 1. lock-free code (see buildNativeAtomicUpdate()) for the updates of the
+//    integer, float, double and long double variables
+// 2. using atomic runtime call otherwise:
+//    __kmpc_atomic_start ();
 //    shared = shared op local;
-//    GOMP_atomic_end (); // void GOMP_atomic_end (void);
-// We use the 2nd method only for now, for simplicity and portability
+//    __kmpc_atomic_end ();
 void transOmpAtomic(SgNode *node) {
   ROSE_ASSERT(node != NULL);
   SgOmpAtomicStatement *target = isSgOmpAtomicStatement(node);
@@ -5334,6 +5839,12 @@ void transOmpAtomic(SgNode *node) {
   SgStatement *body = target->get_body();
   ROSE_ASSERT(body != NULL);
 
+  SgStatement *native_stmt = buildNativeAtomicStatement(target, body, scope);
+  if (native_stmt != NULL) {
+    replaceStatement(target, native_stmt, true);
+    return;
+  }
+
   replaceStatement(target, body, true);
   SgExprStatement *func_call_stmt1 = buildFunctionCallStmt(
       "__kmpc_atomic_start", buildVoidType(), NULL, scope);
@@ -6097,73 +6608,77 @@ static void insertOmpLastprivateCopyBackStmts(
   end_stmt_list.push_back(save_stmt);
 }
 
+//! The operator combining two partial results of a reduction, or V_SgNode if
+//! the reduction is not supported. The partial results of a - reduction are
+//! added, as the OpenMP specification defines its combiner.
+static VariantT
+getReductionCombiner(SgOmpClause::omp_reduction_identifier_enum r_operator) {
+  switch (r_operator) {
+  case SgOmpClause::e_omp_reduction_plus:
+  case SgOmpClause::e_omp_reduction_minus:
+    return V_SgAddOp;
+  case SgOmpClause::e_omp_reduction_mul:
+    return V_SgMultiplyOp;
+  case SgOmpClause::e_omp_reduction_bitand:
+    return V_SgBitAndOp;
+  case SgOmpClause::e_omp_reduction_bitor:
+    return V_SgBitOrOp;
+  case SgOmpClause::e_omp_reduction_bitxor:
+    return V_SgBitXorOp;
+  case SgOmpClause::e_omp_reduction_logand:
+    return V_SgAndOp;
+  case SgOmpClause::e_omp_reduction_logor:
+    return V_SgOrOp;
+  default:
+    return V_SgNode;
+  }
+}
+
 //! Generate copy-back statements for reduction variables
 // end_stmt_list: the statement lists to be appended
 // bb1: the affected code block by the reduction clause
 // orig_var: the reduction variable's original copy
 // local_decl: the local copy of the reduction variable
 // Two ways to do the reduction operation:
-// 1. builtin function TODO
-//    __sync_fetch_and_add_4(&shared, (unsigned int)local);
-// 2. using atomic runtime call:
-//    GOMP_atomic_start ();
+// 1. lock-free code (see buildNativeAtomicUpdate()) for the integer, float,
+//    double and long double variables, e.g.
+//    __atomic_fetch_add(&shared, local, __ATOMIC_RELAXED);
+// 2. using atomic runtime call otherwise:
+//    __kmpc_atomic_start ();
 //    shared = shared op local;
-//    GOMP_atomic_end ();
-// We use the 2nd method only for now for simplicity and portability
+//    __kmpc_atomic_end ();
 static void insertOmpReductionCopyBackStmts(
     SgOmpClause::omp_reduction_identifier_enum r_operator,
     vector<SgStatement *> &end_stmt_list, SgBasicBlock *bb1,
     SgInitializedName *orig_var, SgVariableDeclaration *local_decl,
     SgStatement *node) {
-  SgExprStatement *atomic_start_stmt =
-      buildFunctionCallStmt("__kmpc_atomic_start", buildVoidType(), NULL, bb1);
-  end_stmt_list.push_back(atomic_start_stmt);
   SgExpression *r_exp = NULL;
   SgExpression *orig_var_exp = buildVarRefExp(orig_var, bb1);
   SgOmpExecStatement *target = isSgOmpExecStatement(node);
   if (clause_variable_renaming_record.count(target))
     orig_var_exp = clause_variable_renaming_record[target]->at(orig_var);
-  switch (r_operator) {
-  case SgOmpClause::e_omp_reduction_plus:
-    r_exp = buildAddOp(orig_var_exp, buildVarRefExp(local_decl));
-    break;
-  case SgOmpClause::e_omp_reduction_mul:
-    r_exp = buildMultiplyOp(orig_var_exp, buildVarRefExp(local_decl));
-    break;
-  case SgOmpClause::e_omp_reduction_minus:
-    r_exp = buildSubtractOp(orig_var_exp, buildVarRefExp(local_decl));
-    break;
-  case SgOmpClause::e_omp_reduction_bitand:
-    r_exp = buildBitAndOp(orig_var_exp, buildVarRefExp(local_decl));
-    break;
-  case SgOmpClause::e_omp_reduction_bitor:
-    r_exp = buildBitOrOp(orig_var_exp, buildVarRefExp(local_decl));
-    break;
-  case SgOmpClause::e_omp_reduction_bitxor:
-    r_exp = buildBitXorOp(orig_var_exp, buildVarRefExp(local_decl));
-    break;
-  case SgOmpClause::e_omp_reduction_logand:
-    r_exp = buildAndOp(orig_var_exp, buildVarRefExp(local_decl));
-    break;
-  case SgOmpClause::e_omp_reduction_logor:
-    r_exp = buildOrOp(orig_var_exp, buildVarRefExp(local_decl));
-    break;
-    // TODO Fortran operators.
-  case SgOmpClause::e_omp_reduction_and: // Fortran .and.
-  case SgOmpClause::e_omp_reduction_or:  // Fortran .or.
-  case SgOmpClause::e_omp_reduction_eqv:
-  case SgOmpClause::e_omp_reduction_neqv:
-  case SgOmpClause::e_omp_reduction_max:
-  case SgOmpClause::e_omp_reduction_min:
-  case SgOmpClause::e_omp_reduction_iand:
-  case SgOmpClause::e_omp_reduction_ior:
-  case SgOmpClause::e_omp_reduction_ieor:
-  case SgOmpClause::e_omp_reduction_unknown:
-  case SgOmpClause::e_omp_reduction_last:
-  default:
+
+  // TODO Fortran operators.
+  VariantT native_op = getReductionCombiner(r_operator);
+  if (native_op != V_SgNode) {
+    SgExpression *local_exp = buildVarRefExp(local_decl);
+    SgStatement *native_stmt = buildNativeAtomicUpdate(
+        orig_var_exp, native_op, local_exp, false, "__ATOMIC_RELAXED", bb1);
+    if (native_stmt != NULL) {
+      end_stmt_list.push_back(native_stmt);
+      return;
+    }
+  }
+
+  SgExprStatement *atomic_start_stmt =
+      buildFunctionCallStmt("__kmpc_atomic_start", buildVoidType(), NULL, bb1);
+  end_stmt_list.push_back(atomic_start_stmt);
+  if (native_op != V_SgNode)
+    r_exp = buildAtomicOperation(native_op, orig_var_exp,
+                                 buildVarRefExp(local_decl));
+  else
     cerr << "Illegal or unhandled reduction operator type:" << r_operator
          << endl;
-  }
   SgStatement *reduction_stmt = buildAssignStatement(orig_var_exp, r_exp);
   end_stmt_list.push_back(reduction_stmt);
   SgExprStatement *atomic_end_stmt =
@@ -6171,6 +6686,215 @@ static void insertOmpReductionCopyBackStmts(
   end_stmt_list.push_back(atomic_end_stmt);
 }
 
+//! A reduction variable of a construct and its private copy
+struct OmpReductionVariable {
+  SgOmpClause::omp_reduction_identifier_enum r_operator;
+  SgInitializedName *orig_var;
+  SgVariableDeclaration *local_decl;
+};
+
+//! The original variable of a reduction, as referenced at the end of bb1
+static SgExpression *buildReductionOriginalExp(SgStatement *ompStmt,
+                                               SgInitializedName *orig_var,
+                                               SgBasicBlock *bb1) {
+  SgOmpExecStatement *target = isSgOmpExecStatement(ompStmt);
+  if (clause_variable_renaming_record.count(target))
+    return deepCopy(clause_variable_renaming_record[target]->at(orig_var));
+  return buildVarRefExp(orig_var, bb1);
+}
+
+//! Build the reduce function passed to __kmpc_reduce_nowait() for the
+//! reduction variables of ompStmt and insert it in the global scope, before the
+//! declaration enclosing ompStmt there (the enclosing function, or the class or
+//! namespace of a member or namespace function). Its parameters are two reduction lists (the addresses of the
+//! private copies of two threads) and it combines the second one into the
+//! first one, e.g.
+//!
+//!   static void __rex_reduce_main_9_0(void *__lhs, void *__rhs) {
+//!     *((int *)((void **)__lhs)[0]) =
+//!         *((int *)((void **)__lhs)[0]) + *((int *)((void **)__rhs)[0]);
+//!   }
+static SgFunctionDeclaration *
+buildReduceFunction(SgStatement *ompStmt,
+                    const vector<OmpReductionVariable> &reductions) {
+  SgFunctionDeclaration *enclosing_function =
+      getEnclosingFunctionDeclaration(ompStmt);
+  ROSE_ASSERT(enclosing_function != NULL);
+  SgGlobal *g_scope = getGlobalScope(ompStmt);
+  ROSE_ASSERT(g_scope != NULL);
+
+  string func_name = "__rex_reduce_" +
+                     enclosing_function->get_name().getString() + "_" +
+                     StringUtility::numberToString(
+                         ompStmt->get_startOfConstruct()->get_line()) +
+                     "_" +
+                     StringUtility::numberToString(reduction_function_counter);
+  reduction_function_counter += 1;
+
+  SgType *void_pointer_type = buildPointerType(buildVoidType());
+  SgFunctionParameterList *parameters = buildFunctionParameterList(
+      buildInitializedName("__lhs", void_pointer_type),
+      buildInitializedName("__rhs", void_pointer_type));
+  SgFunctionDeclaration *func = buildDefiningFunctionDeclaration(
+      func_name, buildVoidType(), parameters, g_scope);
+  setStatic(func);
+  SgBasicBlock *func_body = func->get_definition()->get_body();
+
+  for (size_t i = 0; i < reductions.size(); i++) {
+    SgType *element_pointer_type = buildPointerType(
+        getFirstInitializedName(reductions[i].local_decl)->get_type());
+    SgExpression *operands[2];
+    for (int j = 0; j < 2; j++) {
+      SgExpression *list = buildCastExp(
+          buildVarRefExp(j == 0 ? "__lhs" : "__rhs", func_body),
+          buildPointerType(void_pointer_type));
+      operands[j] = buildPointerDerefExp(buildCastExp(
+          buildPntrArrRefExp(list, buildIntVal(i)), element_pointer_type));
+    }
+    appendStatement(
+        buildAssignStatement(
+            operands[0],
+            buildAtomicOperation(getReductionCombiner(reductions[i].r_operator),
+                                 deepCopy(operands[0]), operands[1])),
+        func_body);
+  }
+
+  // the function is built in the global scope, insert it there
+  SgStatement *top_level_stmt = enclosing_function;
+  while (top_level_stmt->get_parent() != g_scope) {
+    top_level_stmt = isSgStatement(top_level_stmt->get_parent());
+    ROSE_ASSERT(top_level_stmt != NULL);
+  }
+  insertStatementBefore(top_level_stmt, func);
+  reduction_functions[func_name] = func;
+  return func;
+}
+
+//! Generate the statements combining the private copies of the reduction
+//! variables of ompStmt into the original variables with the tree reduction of
+//! the runtime:
+//!
+//!   int __global_tid_main_9_1 = __kmpc_global_thread_num(0);
+//!   static ident_t __rex_reduction_loc = {0, 0x12, 0, 0, ";unknown;..."};
+//!   static int __rex_reduction_lock[8];
+//!   void *__rex_reduction_list[2] = {&_p_sum, &_p_prod};
+//!   switch (__kmpc_reduce_nowait(&__rex_reduction_loc, __global_tid_main_9_1,
+//!             2, sizeof(__rex_reduction_list), __rex_reduction_list,
+//!             __rex_reduce_main_9_0, &__rex_reduction_lock)) {
+//!   case 1: {
+//!     sum = sum + _p_sum;
+//!     prod = prod * _p_prod;
+//!     __kmpc_end_reduce_nowait(&__rex_reduction_loc, __global_tid_main_9_1,
+//!                              &__rex_reduction_lock);
+//!     break;
+//!   }
+//!   case 2: {
+//!     __atomic_fetch_add(&sum, _p_sum, __ATOMIC_RELAXED);
+//!     ... (see buildNativeAtomicUpdate())
+//!     break;
+//!   }
+//!   }
+//!
+// The runtime picks the method from the team size: 1 for a team of one thread,
+// the master of a tree reduction (the other threads get 0 and do nothing) or a
+// critical section, 2 for every thread when the atomic updates are allowed. They
+// are only allowed (KMP_IDENT_ATOMIC_REDUCE in the flags of the location) when
+// all the variables have a lock-free update, so case 2 is omitted otherwise. The
+// nowait variants are used since the constructs add their own barrier, if any.
+static void insertOmpTreeReductionStmts(
+    SgStatement *ompStmt, const vector<OmpReductionVariable> &reductions,
+    vector<SgStatement *> &end_stmt_list, SgBasicBlock *bb1) {
+  ROSE_ASSERT(!reductions.empty());
+
+  SgBasicBlock *combine_body = buildBasicBlock();
+  SgBasicBlock *atomic_body = buildBasicBlock();
+  bool atomic_available = true;
+  SgExprListExp *list_elements = buildExprListExp();
+  for (size_t i = 0; i < reductions.size(); i++) {
+    VariantT op = getReductionCombiner(reductions[i].r_operator);
+    SgExpression *orig_var_exp =
+        buildReductionOriginalExp(ompStmt, reductions[i].orig_var, bb1);
+    appendStatement(
+        buildAssignStatement(
+            orig_var_exp,
+            buildAtomicOperation(op, deepCopy(orig_var_exp),
+                                 buildVarRefExp(reductions[i].local_decl))),
+        combine_body);
+    if (atomic_available) {
+      SgStatement *native_stmt = buildNativeAtomicUpdate(
+          orig_var_exp, op, buildVarRefExp(reductions[i].local_decl), false,
+          "__ATOMIC_RELAXED", bb1);
+      if (native_stmt != NULL)
+        appendStatement(native_stmt, atomic_body);
+      else
+        atomic_available = false;
+    }
+    list_elements->append_expression(
+        buildAddressOfOp(buildVarRefExp(reductions[i].local_decl)));
+  }
+
+  SgFunctionDeclaration *reduce_func = buildReduceFunction(ompStmt, reductions);
+
+  SgVariableDeclaration *kmpc_global_tid_declaration =
+      get_kmpc_global_tid(ompStmt, bb1);
+  end_stmt_list.push_back(kmpc_global_tid_declaration);
+
+  // KMP_IDENT_KMPC | KMP_IDENT_ATOMIC_REDUCE
+  SgExprListExp *loc_fields = buildExprListExp(
+      buildIntVal(0), buildIntValHex(atomic_available ? 0x12 : 0x02),
+      buildIntVal(0), buildIntVal(0), buildStringVal(";unknown;unknown;0;0;;"));
+  SgType *ident_type = buildOpaqueType("ident_t", bb1);
+  SgVariableDeclaration *loc_decl = buildVariableDeclaration(
+      "__rex_reduction_loc", ident_type,
+      buildAggregateInitializer(loc_fields, ident_type), bb1);
+  setStatic(loc_decl);
+  end_stmt_list.push_back(loc_decl);
+
+  // kmp_critical_name, zero initialized
+  SgVariableDeclaration *lock_decl = buildVariableDeclaration(
+      "__rex_reduction_lock", buildArrayType(buildIntType(), buildIntVal(8)),
+      NULL, bb1);
+  setStatic(lock_decl);
+  end_stmt_list.push_back(lock_decl);
+
+  SgType *list_type =
+      buildArrayType(buildPointerType(buildVoidType()),
+                     buildIntVal(reductions.size()));
+  SgVariableDeclaration *list_decl = buildVariableDeclaration(
+      "__rex_reduction_list", list_type,
+      buildAggregateInitializer(list_elements, list_type), bb1);
+  end_stmt_list.push_back(list_decl);
+
+  SgExpression *thread_global_tid =
+      buildVarRefExp(kmpc_global_tid_declaration);
+  SgExprListExp *reduce_parameters = buildExprListExp(
+      buildAddressOfOp(buildVarRefExp(loc_decl)), thread_global_tid,
+      buildIntVal(reductions.size()), buildSizeOfOp(buildVarRefExp(list_decl)),
+      buildVarRefExp(list_decl), buildFunctionRefExp(reduce_func),
+      buildAddressOfOp(buildVarRefExp(lock_decl)));
+  SgExpression *reduce_call = buildFunctionCallExp(
+      "__kmpc_reduce_nowait", buildIntType(), reduce_parameters, bb1);
+
+  SgExprListExp *end_parameters = buildExprListExp(
+      buildAddressOfOp(buildVarRefExp(loc_decl)),
+      buildVarRefExp(kmpc_global_tid_declaration),
+      buildAddressOfOp(buildVarRefExp(lock_decl)));
+  appendStatement(buildFunctionCallStmt("__kmpc_end_reduce_nowait",
+                                        buildVoidType(), end_parameters, bb1),
+                  combine_body);
+  appendStatement(buildBreakStmt(), combine_body);
+
+  SgBasicBlock *switch_body = buildBasicBlock();
+  appendStatement(buildCaseOptionStmt(buildIntVal(1), combine_body),
+                  switch_body);
+  if (atomic_available) {
+    appendStatement(buildBreakStmt(), atomic_body);
+    appendStatement(buildCaseOptionStmt(buildIntVal(2), atomic_body),
+                    switch_body);
+  }
+  end_stmt_list.push_back(buildSwitchStatement(reduce_call, switch_body));
+}
+
 //! Liao 2/12/2013. Insert the thread-block inner level reduction statement into
 //! the end of the end_stmt_list
 // e.g.  xomp_inner_block_reduction_float (local_error, per_block_error,
@@ -6444,6 +7168,13 @@ void transOmpVariables(SgStatement *ompStmt, SgBasicBlock *bb1,
   ASTtools::VarSymSet_t var_set;
 
   vector<SgStatement *> front_stmt_list, end_stmt_list, front_init_list;
+  // the reduction variables of a construct executed by a team are combined
+  // together with the runtime's tree reduction after the loop below
+  vector<OmpReductionVariable> tree_reductions;
+  bool use_tree_reduction =
+      !isAcceleratorModel && !SageInterface::is_Fortran_language() &&
+      (isSgOmpParallelStatement(ompStmt) || isSgOmpForStatement(ompStmt) ||
+       isSgOmpSectionsStatement(ompStmt));
 
   // this is call by both transOmpTargetParallel and transOmpTargetLoop, we
   // should move this to the correct caller place
@@ -6630,13 +7361,20 @@ void transOmpVariables(SgStatement *ompStmt, SgBasicBlock *bb1,
       if (isAcceleratorModel)
         insertInnerThreadBlockReduction(r_operator, end_stmt_list, bb1,
                                         orig_var, local_decl, per_block_decl);
-      else
+      else if (use_tree_reduction && local_decl != NULL &&
+               getReductionCombiner(r_operator) != V_SgNode) {
+        OmpReductionVariable reduction = {r_operator, orig_var, local_decl};
+        tree_reductions.push_back(reduction);
+      } else
         insertOmpReductionCopyBackStmts(r_operator, end_stmt_list, bb1,
                                         orig_var, local_decl, ompStmt);
     }
 
   } // end for (each variable)
 
+  if (!tree_reductions.empty())
+    insertOmpTreeReductionStmts(ompStmt, tree_reductions, end_stmt_list, bb1);
+
   // step 4. Variable replacement for all original bb1
   replaceVariableReferences(bb1, var_map);
   replaceVariablesWithPointerDereference(
@@ -7113,6 +7851,325 @@ bool isInOmpTargetOffloadingFunc(SgNode *node) {
     return false;
 }
 
+//! Lower an OpenMP construct which has no enclosing OpenMP construct left
+static void lowerOmpConstruct(SgStatement *node) {
+  ROSE_ASSERT(node != NULL);
+
+  // check if it is a variant
+  bool isVariant = isSgOmpWhenClause(node->get_parent()) ||
+                   isSgOmpDefaultClause(node->get_parent());
+  if (isVariant) {
+    std::cout << "It is a variant, which should have been transformed.\n";
+    ROSE_ASSERT(0);
+  }
+
+  if (!isVariant)
+    switch (node->variantT()) {
+    case V_SgOmpParallelStatement: {
+      // check if this parallel region is under "omp target"
+      SgNode *parent = node->get_parent();
+      ROSE_ASSERT(parent != NULL);
+      if (isSgBasicBlock(parent)) // skip the padding block in between.
+        parent = parent->get_parent();
+      if (isSgOmpTargetStatement(parent))
+        transOmpTargetParallel(node);
+      /*
+      if (isInOmpTargetOffloadingFunc(node))
+        transOmpSpmdInTargetRegion(node);
+      */
+      else
+        transOmpParallel(node);
+      break;
+    }
+    case V_SgOmpSectionsStatement: {
+      transOmpSections(node);
+      break;
+    }
+
+    case V_SgOmpTaskStatement: {
+      transOmpTask(node);
+      break;
+    }
+    case V_SgOmpForStatement:
+    case V_SgOmpDoStatement: {
+      /*Winnie, handle Collapse clause.*/
+      if (hasClause(node, V_SgOmpCollapseClause))
+        transOmpCollapse(node);
+
+      if (isInOmpTargetOffloadingFunc(node))
+        transOmpLoopInTargetRegion(node);
+      else
+        transOmpLoop(node);
+
+      break;
+    }
+    case V_SgOmpBarrierStatement: {
+      transOmpBarrier(node);
+      break;
+    }
+    case V_SgOmpFlushStatement: {
+      transOmpFlush(node);
+      break;
+    }
+
+    case V_SgOmpThreadprivateStatement: {
+      transOmpThreadprivate(node);
+      break;
+    }
+    case V_SgOmpTaskwaitStatement: {
+      transOmpTaskwait(node);
+      break;
+    }
+    case V_SgOmpSingleStatement: {
+      transOmpSingle(node);
+      break;
+    }
+    case V_SgOmpMasterStatement: {
+      transOmpMaster(node);
+      break;
+    }
+    case V_SgOmpAtomicStatement: {
+      transOmpAtomic(node);
+      break;
+    }
+    case V_SgOmpOrderedStatement: {
+      transOmpOrdered(node);
+      break;
+    }
+    case V_SgOmpCriticalStatement: {
+      transOmpCritical(node);
+      break;
+    }
+    case V_SgOmpTargetStatement: {
+      transOmpTarget(node);
+      break;
+    }
+    case V_SgOmpTargetTeamsStatement: {
+      transOmpTargetTeams(node);
+      break;
+    }
+    case V_SgOmpTargetParallelStatement: {
+      transOmpTargetParallel(node);
+      break;
+    }
+    case V_SgOmpTargetDataStatement: {
+      transOmpTargetData(node);
+      break;
+    }
+    case V_SgOmpTargetUpdateStatement: {
+      transOmpTargetUpdate(node);
+      break;
+    }
+    case V_SgOmpTargetTeamsDistributeStatement: {
+      transOmpTargetTeamsDistribute(node);
+      break;
+    }
+    case V_SgOmpTargetParallelForStatement: {
+      transOmpTargetParallelFor(node);
+      break;
+    }
+    case V_SgOmpTargetTeamsDistributeParallelForStatement: {
+      transOmpTargetTeamsDistributeParallelFor(node);
+      break;
+    }
+    case V_SgOmpSimdStatement:
+    case V_SgOmpUnrollStatement:
+    case V_SgOmpTileStatement: {
+      std::vector<SgStatement *> loop_trans_nodes;
+      SgStatement *frontier = node;
+      while (frontier != NULL) {
+        bool is_omp_loop_transformation = false;
+        switch (frontier->variantT()) {
+        case V_SgOmpSimdStatement:
+        case V_SgOmpUnrollStatement:
+        case V_SgOmpTileStatement:
+          loop_trans_nodes.push_back(frontier);
+          is_omp_loop_transformation = true;
+          break;
+        default:;
+        }
+        if (is_omp_loop_transformation == false)
+          break;
+
+        frontier = isSgOmpBodyStatement(frontier)->get_body();
+        // skip basic blocks if any
+        SgBasicBlock *body = isSgBasicBlock(frontier);
+        while (body != NULL) {
+          const SgStatementPtrList &bb_statements = body->get_statements();
+          if (bb_statements.size() == 1) {
+            body = isSgBasicBlock(bb_statements[0]);
+            frontier = bb_statements[0];
+          } else {
+            frontier = NULL;
+            break;
+          }
+        }
+      }
+      for (int i = loop_trans_nodes.size() - 1; i >= 0; i--) {
+        switch (loop_trans_nodes[i]->variantT()) {
+        case V_SgOmpSimdStatement:
+          if (hasClause(loop_trans_nodes[i], V_SgOmpCollapseClause))
+            transOmpCollapse(loop_trans_nodes[i]);
+          transOmpSimd(loop_trans_nodes[i]);
+          break;
+        case V_SgOmpUnrollStatement:
+          transOmpUnroll(loop_trans_nodes[i]);
+          break;
+        case V_SgOmpTileStatement:
+          transOmpTile(loop_trans_nodes[i]);
+          break;
+        }
+      }
+      break;
+    }
+    default: {
+      std::cout << "Unexpected OpenMP construct: "
+                << node->sage_class_name() << "\n";
+      ROSE_ASSERT(0);
+    }
+    } // switch
+}
+
+//! The place of an OpenMP construct in the AST before it is lowered, to find
+//! the OpenMP constructs generated by its lowering afterwards (the constructs
+//! nested in it, which the lowering may copy: the loop of omp for, the body of
+//! omp parallel outlined and moved to the rex_lib file)
+struct OmpConstructPlace {
+  SgSourceFile *file;   // the file of the construct
+  SgNode *parent;       // the parent of the construct
+  SgStatement *previous; // the statements before and after the construct if
+  SgStatement *next;     // the parent is a basic block (NULL at the ends)
+  size_t target_outlined_functions; // size of target_outlined_function_list
+  SgSourceFile *outlined_file;      // cpu_outlined_file
+  size_t outlined_declarations;     // declarations in cpu_outlined_file
+};
+
+static OmpConstructPlace getOmpConstructPlace(SgStatement *node) {
+  OmpConstructPlace place;
+  place.file = getEnclosingNode<SgSourceFile>(node);
+  place.parent = node->get_parent();
+  place.previous = NULL;
+  place.next = NULL;
+  SgBasicBlock *block = isSgBasicBlock(place.parent);
+  if (block != NULL) {
+    SgStatementPtrList &statements = block->get_statements();
+    SgStatementPtrList::iterator i =
+        std::find(statements.begin(), statements.end(), node);
+    ROSE_ASSERT(i != statements.end());
+    if (i != statements.begin())
+      place.previous = *(i - 1);
+    if (i + 1 != statements.end())
+      place.next = *(i + 1);
+  }
+  place.target_outlined_functions = target_outlined_function_list->size();
+  place.outlined_file = cpu_outlined_file;
+  place.outlined_declarations =
+      cpu_outlined_file != NULL
+          ? cpu_outlined_file->get_globalScope()->get_declarations().size()
+          : 0;
+  return place;
+}
+
+//! Collect the OpenMP constructs generated by the lowering of the construct
+//! which was at the given place: in the statements now between its previous
+//! and next statements (or under its parent if they are gone or the parent is
+//! not a basic block), in the new target outlined functions and in the
+//! declarations added to cpu_outlined_file. The ones in the file of the
+//! construct are added to in_file, the ones in cpu_outlined_file to
+//! in_outlined_file, both in preorder.
+static void
+collectGeneratedOmpConstructs(const OmpConstructPlace &place,
+                              Rose_STL_Container<SgNode *> &in_file,
+                              Rose_STL_Container<SgNode *> &in_outlined_file) {
+  std::vector<SgNode *> subtrees;
+  SgBasicBlock *block = isSgBasicBlock(place.parent);
+  bool found = false;
+  if (block != NULL) {
+    SgStatementPtrList &statements = block->get_statements();
+    SgStatementPtrList::iterator begin = statements.begin();
+    SgStatementPtrList::iterator end = statements.end();
+    found = true;
+    if (place.previous != NULL) {
+      begin = std::find(statements.begin(), statements.end(), place.previous);
+      if (begin == statements.end())
+        found = false;
+      else
+        begin++;
+    }
+    if (found && place.next != NULL) {
+      end = std::find(begin, statements.end(), place.next);
+      if (end == statements.end())
+        found = false;
+    }
+    if (found)
+      subtrees.insert(subtrees.end(), begin, end);
+  }
+  if (!found)
+    subtrees.push_back(place.parent);
+  for (size_t i = place.target_outlined_functions;
+       i < target_outlined_function_list->size(); i++)
+    subtrees.push_back((*target_outlined_function_list)[i]);
+
+  Rose_STL_Container<SgNode *> &slot_constructs =
+      (place.file != NULL && place.file == cpu_outlined_file)
+          ? in_outlined_file
+          : in_file;
+  for (size_t i = 0; i < subtrees.size(); i++) {
+    Rose_STL_Container<SgNode *> constructs =
+        NodeQuery::querySubTree(subtrees[i], V_SgOmpExecStatement);
+    slot_constructs.insert(slot_constructs.end(), constructs.begin(),
+                           constructs.end());
+  }
+
+  if (cpu_outlined_file == NULL)
+    return;
+  SgDeclarationStatementPtrList &declarations =
+      cpu_outlined_file->get_globalScope()->get_declarations();
+  // a new rex_lib file is a copy of the input file, searched as a whole
+  size_t first = place.outlined_declarations;
+  if (place.outlined_file != cpu_outlined_file || first > declarations.size())
+    first = 0;
+  for (size_t i = first; i < declarations.size(); i++) {
+    Rose_STL_Container<SgNode *> constructs =
+        NodeQuery::querySubTree(declarations[i], V_SgOmpExecStatement);
+    in_outlined_file.insert(in_outlined_file.end(), constructs.begin(),
+                            constructs.end());
+  }
+}
+
+//! Collect the OpenMP constructs without an enclosing OpenMP construct in the
+//! file and in cpu_outlined_file, in preorder
+static void collectOutermostOmpConstructs(SgSourceFile *file,
+                                          std::vector<SgStatement *> &result) {
+  // Fix the parent-children relationship between UPIR nodes
+  OmpSupport::createOmpStatementTree(file);
+  if (cpu_outlined_file != NULL) {
+    OmpSupport::createOmpStatementTree(cpu_outlined_file);
+  }
+  // Collect all the OpenMP nodes
+  Rose_STL_Container<SgNode *> nodeList =
+      NodeQuery::querySubTree(file, V_SgOmpExecStatement);
+  if (cpu_outlined_file != NULL) {
+    nodeList = mergeSgNodeList(
+        nodeList,
+        NodeQuery::querySubTree(cpu_outlined_file, V_SgOmpExecStatement));
+  }
+  // Collect all the OpenMP nodes without OpenMP parent
+  for (Rose_STL_Container<SgNode *>::iterator iter = nodeList.begin();
+       iter != nodeList.end(); iter++) {
+    SgOmpExecStatement *omp_node = isSgOmpExecStatement(*iter);
+    ROSE_ASSERT(omp_node != NULL);
+    if (omp_node->get_omp_parent() == NULL)
+      result.push_back(omp_node);
+  }
+}
+
+//! Time spent lowering each kind of OpenMP construct (-rose:verbose > 0)
+struct OmpLoweringTiming {
+  size_t constructs;
+  double seconds;
+};
+
 //! Bottom-up processing AST tree to translate all OpenMP constructs
 // the major interface of omp_lowering
 // We now operation on scoped OpenMP regions and blocks
@@ -7126,6 +8183,14 @@ bool isInOmpTargetOffloadingFunc(SgNode *node) {
 //               \          #
 //                \         #
 //                SgOmpParallelStatement
+//
+// The constructs are lowered outermost first, in rounds as if the file was
+// searched again for the outermost constructs after each round: the
+// outermost constructs of the file are collected once, and the constructs
+// generated by the lowering of a construct (the copies of the constructs
+// nested in it) are searched for only where the lowering put them (see
+// collectGeneratedOmpConstructs()), for the next round. The file is searched
+// again at the end, in case a translation put constructs elsewhere.
 void lower_omp(SgSourceFile *file) {
   ROSE_ASSERT(file != NULL);
 
@@ -7139,213 +8204,85 @@ void lower_omp(SgSourceFile *file) {
 
   target_outlined_function_list = new std::vector<SgFunctionDeclaration *>();
 
-  Rose_STL_Container<SgNode *> omp_nodes;
-  do {
-    omp_nodes.clear();
-    // Fix the parent-children relationship between UPIR nodes
-    OmpSupport::createOmpStatementTree(file);
-    if (cpu_outlined_file != NULL) {
-      OmpSupport::createOmpStatementTree(cpu_outlined_file);
-    }
-    Rose_STL_Container<SgNode *>::iterator iter;
-    // Collect all the OpenMP nodes
-    Rose_STL_Container<SgNode *> nodeList =
-        NodeQuery::querySubTree(file, V_SgOmpExecStatement);
-    if (cpu_outlined_file != NULL) {
-      nodeList = mergeSgNodeList(
-          nodeList,
-          NodeQuery::querySubTree(cpu_outlined_file, V_SgOmpExecStatement));
-    }
-    // Collect all the OpenMP nodes without OpenMP parent
-    for (iter = nodeList.begin(); iter != nodeList.end(); iter++) {
-      SgOmpExecStatement *omp_node = isSgOmpExecStatement(*iter);
-      ROSE_ASSERT(omp_node != NULL);
-      SgOmpExecStatement *omp_parent =
-          isSgOmpExecStatement(omp_node->get_omp_parent());
-      if (omp_parent == NULL) {
-        omp_nodes.push_back(omp_node);
-      }
-    }
-
-    for (iter = omp_nodes.begin(); iter != omp_nodes.end(); iter++) {
-      SgStatement *node = isSgStatement(*iter);
-      ROSE_ASSERT(node != NULL);
-
-      // check if it is a variant
-      bool isVariant = isSgOmpWhenClause(node->get_parent()) ||
-                       isSgOmpDefaultClause(node->get_parent());
-      if (isVariant) {
-        std::cout << "It is a variant, which should have been transformed.\n";
-        ROSE_ASSERT(0);
-      }
-
-      if (!isVariant)
-        switch (node->variantT()) {
-        case V_SgOmpParallelStatement: {
-          // check if this parallel region is under "omp target"
-          SgNode *parent = node->get_parent();
-          ROSE_ASSERT(parent != NULL);
-          if (isSgBasicBlock(parent)) // skip the padding block in between.
-            parent = parent->get_parent();
-          if (isSgOmpTargetStatement(parent))
-            transOmpTargetParallel(node);
-          /*
-          if (isInOmpTargetOffloadingFunc(node))
-            transOmpSpmdInTargetRegion(node);
-          */
-          else
-            transOmpParallel(node);
-          break;
+  bool timing = SgProject::get_verbose() > 0;
+  std::map<std::string, OmpLoweringTiming> timings;
+  size_t lowered_constructs = 0;
+  std::chrono::steady_clock::time_point lowering_start =
+      std::chrono::steady_clock::now();
+
+  std::vector<SgStatement *> round;
+  collectOutermostOmpConstructs(file, round);
+  while (round.size() != 0) {
+    // the constructs to lower in this round, and the next round's ones in the
+    // file and in cpu_outlined_file
+    std::set<SgNode *> queued(round.begin(), round.end());
+    Rose_STL_Container<SgNode *> next_in_file;
+    Rose_STL_Container<SgNode *> next_in_outlined_file;
+    do {
+      for (size_t i = 0; i < round.size(); i++) {
+        SgStatement *node = round[i];
+        queued.erase(node);
+        OmpConstructPlace place = getOmpConstructPlace(node);
+        std::string kind = node->class_name();
+        int line = node->get_file_info()->get_line();
+
+        std::chrono::steady_clock::time_point start =
+            std::chrono::steady_clock::now();
+        lowerOmpConstruct(node);
+        if (timing) {
+          std::chrono::duration<double> elapsed =
+              std::chrono::steady_clock::now() - start;
+          OmpLoweringTiming &t = timings[kind];
+          t.constructs++;
+          t.seconds += elapsed.count();
+          if (SgProject::get_verbose() > 1)
+            printf("OpenMP lowering: %s at line %d: %.3g s\n", kind.c_str(),
+                   line, elapsed.count());
         }
-        case V_SgOmpSectionsStatement: {
-          transOmpSections(node);
-          break;
+        lowered_constructs++;
+
+        Rose_STL_Container<SgNode *> in_file, in_outlined_file;
+        collectGeneratedOmpConstructs(place, in_file, in_outlined_file);
+        OmpSupport::createOmpStatementTree(in_file);
+        OmpSupport::createOmpStatementTree(in_outlined_file);
+        for (size_t j = 0; j < in_file.size(); j++) {
+          if (isSgOmpExecStatement(in_file[j])->get_omp_parent() == NULL &&
+              queued.insert(in_file[j]).second)
+            next_in_file.push_back(in_file[j]);
         }
-
-        case V_SgOmpTaskStatement: {
-          transOmpTask(node);
-          break;
+        for (size_t j = 0; j < in_outlined_file.size(); j++) {
+          if (isSgOmpExecStatement(in_outlined_file[j])->get_omp_parent() ==
+                  NULL &&
+              queued.insert(in_outlined_file[j]).second)
+            next_in_outlined_file.push_back(in_outlined_file[j]);
         }
-        case V_SgOmpForStatement:
-        case V_SgOmpDoStatement: {
-          /*Winnie, handle Collapse clause.*/
-          if (hasClause(node, V_SgOmpCollapseClause))
-            transOmpCollapse(node);
-
-          if (isInOmpTargetOffloadingFunc(node))
-            transOmpLoopInTargetRegion(node);
-          else
-            transOmpLoop(node);
+      }
 
-          break;
-        }
-        case V_SgOmpBarrierStatement: {
-          transOmpBarrier(node);
-          break;
-        }
-        case V_SgOmpFlushStatement: {
-          transOmpFlush(node);
-          break;
-        }
+      // the next round: the constructs of the file, then the ones of
+      // cpu_outlined_file
+      round.clear();
+      for (size_t i = 0; i < next_in_file.size(); i++)
+        round.push_back(isSgStatement(next_in_file[i]));
+      for (size_t i = 0; i < next_in_outlined_file.size(); i++)
+        round.push_back(isSgStatement(next_in_outlined_file[i]));
+      next_in_file.clear();
+      next_in_outlined_file.clear();
+    } while (round.size() != 0);
+
+    collectOutermostOmpConstructs(file, round);
+  }
 
-        case V_SgOmpThreadprivateStatement: {
-          transOmpThreadprivate(node);
-          break;
-        }
-        case V_SgOmpTaskwaitStatement: {
-          transOmpTaskwait(node);
-          break;
-        }
-        case V_SgOmpSingleStatement: {
-          transOmpSingle(node);
-          break;
-        }
-        case V_SgOmpMasterStatement: {
-          transOmpMaster(node);
-          break;
-        }
-        case V_SgOmpAtomicStatement: {
-          transOmpAtomic(node);
-          break;
-        }
-        case V_SgOmpOrderedStatement: {
-          transOmpOrdered(node);
-          break;
-        }
-        case V_SgOmpCriticalStatement: {
-          transOmpCritical(node);
-          break;
-        }
-        case V_SgOmpTargetStatement: {
-          transOmpTarget(node);
-          break;
-        }
-        case V_SgOmpTargetTeamsStatement: {
-          transOmpTargetTeams(node);
-          break;
-        }
-        case V_SgOmpTargetParallelStatement: {
-          transOmpTargetParallel(node);
-          break;
-        }
-        case V_SgOmpTargetDataStatement: {
-          transOmpTargetData(node);
-          break;
-        }
-        case V_SgOmpTargetUpdateStatement: {
-          transOmpTargetUpdate(node);
-          break;
-        }
-        case V_SgOmpTargetTeamsDistributeStatement: {
-          transOmpTargetTeamsDistribute(node);
-          break;
-        }
-        case V_SgOmpTargetParallelForStatement: {
-          transOmpTargetParallelFor(node);
-          break;
-        }
-        case V_SgOmpTargetTeamsDistributeParallelForStatement: {
-          transOmpTargetTeamsDistributeParallelFor(node);
-          break;
-        }
-        case V_SgOmpSimdStatement:
-        case V_SgOmpUnrollStatement:
-        case V_SgOmpTileStatement: {
-          std::vector<SgStatement *> loop_trans_nodes;
-          SgStatement *frontier = node;
-          while (frontier != NULL) {
-            bool is_omp_loop_transformation = false;
-            switch (frontier->variantT()) {
-            case V_SgOmpSimdStatement:
-            case V_SgOmpUnrollStatement:
-            case V_SgOmpTileStatement:
-              loop_trans_nodes.push_back(frontier);
-              is_omp_loop_transformation = true;
-              break;
-            default:;
-            }
-            if (is_omp_loop_transformation == false)
-              break;
-
-            frontier = isSgOmpBodyStatement(frontier)->get_body();
-            // skip basic blocks if any
-            SgBasicBlock *body = isSgBasicBlock(frontier);
-            while (body != NULL) {
-              const SgStatementPtrList &bb_statements = body->get_statements();
-              if (bb_statements.size() == 1) {
-                body = isSgBasicBlock(bb_statements[0]);
-                frontier = bb_statements[0];
-              } else {
-                frontier = NULL;
-                break;
-              }
-            }
-          }
-          for (int i = loop_trans_nodes.size() - 1; i >= 0; i--) {
-            switch (loop_trans_nodes[i]->variantT()) {
-            case V_SgOmpSimdStatement:
-              if (hasClause(loop_trans_nodes[i], V_SgOmpCollapseClause))
-                transOmpCollapse(loop_trans_nodes[i]);
-              transOmpSimd(loop_trans_nodes[i]);
-              break;
-            case V_SgOmpUnrollStatement:
-              transOmpUnroll(loop_trans_nodes[i]);
-              break;
-            case V_SgOmpTileStatement:
-              transOmpTile(loop_trans_nodes[i]);
-              break;
-            }
-          }
-          break;
-        }
-        default: {
-          std::cout << "Unexpected OpenMP construct: "
-                    << node->sage_class_name() << "\n";
-          ROSE_ASSERT(0);
-        }
-        } // switch
-    }
-  } while (omp_nodes.size() != 0);
+  if (timing) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - lowering_start;
+    printf("OpenMP lowering of %s: %zu constructs in %.3g s\n",
+           file->getFileName().c_str(), lowered_constructs, elapsed.count());
+    for (std::map<std::string, OmpLoweringTiming>::iterator i =
+             timings.begin();
+         i != timings.end(); i++)
+      printf("  %-40s %8zu constructs %10.3g s\n", i->first.c_str(),
+             i->second.constructs, i->second.seconds);
+  }
 
   // post processing
   post_processing(file);
@@ -7444,6 +8381,27 @@ move_outlined_function(SgFunctionDeclaration *outlined_func,
       .get_storageModifier()
       .setUnspecified();
   new_outlined_function->set_scope(new_scope);
+
+  // move the reduce functions called by the outlined function before it
+  Rose_STL_Container<SgNode *> function_refs =
+      NodeQuery::querySubTree(new_outlined_function, V_SgFunctionRefExp);
+  for (Rose_STL_Container<SgNode *>::iterator i = function_refs.begin();
+       i != function_refs.end(); i++) {
+    std::string name =
+        isSgFunctionRefExp(*i)->get_symbol()->get_name().getString();
+    std::map<string, SgFunctionDeclaration *>::iterator reduce_func =
+        reduction_functions.find(name);
+    if (reduce_func == reduction_functions.end() ||
+        getGlobalScope(reduce_func->second) == new_scope)
+      continue;
+    SgFunctionDeclaration *new_reduce_func =
+        isSgFunctionDeclaration(deepCopy(reduce_func->second));
+    new_reduce_func->set_scope(new_scope);
+    appendStatement(new_reduce_func, new_scope);
+    removeStatement(reduce_func->second);
+    reduce_func->second = new_reduce_func;
+  }
+
   SageInterface::fixVariableReferences(new_file, false);
   appendStatement(new_outlined_function, new_scope);
 
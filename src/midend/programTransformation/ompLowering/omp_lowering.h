@@ -26,6 +26,13 @@ extern bool enable_accelerator;
 // automatically manage data as much as possible. instead of generating explicit
 // data allocation, copy, free functions.
 extern bool useDDE /* = true */;
+
+// A flag to schedule the iterations of omp for loops with the default or
+// schedule(static) schedule (without a chunk size and without ordered) in the
+// generated code, from omp_get_thread_num() and omp_get_num_threads(), instead
+// of calling __kmpc_for_static_init/__kmpc_for_static_fini
+// (-rose:openmp:inline_static_schedule).
+extern bool inline_static_schedule /* = false */;
 //! makeDataSharingExplicit() can call some of existing functions for some work
 //! in OmpSupport namespace by Hongyi 07/16/2012
 //! TODO: add a function within the OmpSupport namespace, the function should
@@ -145,6 +152,7 @@ void transOmpTile(SgNode *node);
 
 //! Analysis helpers
 void createOmpStatementTree(SgSourceFile *file);
+void createOmpStatementTree(const Rose_STL_Container<SgNode *> &node_list);
 SgStatement *getOmpParent(SgStatement *node);
 void setOmpRelationship(SgStatement *parent, SgStatement *child);
 Rose_STL_Container<SgNode *>
@@ -9,6 +9,8 @@ typedef struct ident {
   char const *psource;
 } ident_t;
 
+typedef int32_t kmp_critical_name[8];
+
 struct __tgt_offload_entry {
   void *addr;       // Pointer to the offload entry info (function or global)
   char *name;       // Name of the function or global
@@ -41,8 +43,14 @@ extern "C" {
 void __kmpc_fork_call(ident_t *, int, void *, ...);
 void __kmpc_atomic_start(void);
 void __kmpc_atomic_end(void);
+void __kmpc_atomic_float10_add(ident_t *, int, long double *, long double);
+void __kmpc_atomic_float10_sub(ident_t *, int, long double *, long double);
+void __kmpc_atomic_float10_mul(ident_t *, int, long double *, long double);
+void __kmpc_atomic_float10_div(ident_t *, int, long double *, long double);
 void __kmpc_push_num_threads(ident_t *, int, int);
 int __kmpc_global_thread_num(ident_t *);
+int omp_get_num_threads(void);
+int omp_get_thread_num(void);
 int __kmpc_single(ident_t *, int);
 void __kmpc_end_single(ident_t *, int);
 void __kmpc_barrier(ident_t *, int);
@@ -50,9 +58,33 @@ int __kmpc_serialized_parallel(ident_t *, int);
 void __kmpc_end_serialized_parallel(ident_t *, int);
 void __kmpc_for_static_init_4(ident_t *, int, int, int *, int *, int *, int *,
                               int, int);
+void __kmpc_for_static_init_4u(ident_t *, int, int, int *, unsigned int *,
+                               unsigned int *, int *, int, int);
+void __kmpc_for_static_init_8(ident_t *, int, int, int *, int64_t *, int64_t *,
+                              int64_t *, int64_t, int64_t);
+void __kmpc_for_static_init_8u(ident_t *, int, int, int *, uint64_t *,
+                               uint64_t *, int64_t *, int64_t, int64_t);
 void __kmpc_for_static_fini(ident_t *, int);
 void __kmpc_dispatch_init_4(ident_t *, int, int, int, int, int, int);
+void __kmpc_dispatch_init_4u(ident_t *, int, int, unsigned int, unsigned int,
+                             int, int);
+void __kmpc_dispatch_init_8(ident_t *, int, int, int64_t, int64_t, int64_t,
+                            int64_t);
+void __kmpc_dispatch_init_8u(ident_t *, int, int, uint64_t, uint64_t, int64_t,
+                             int64_t);
 int __kmpc_dispatch_next_4(ident_t *, int, int *, int *, int *, int *);
+int __kmpc_dispatch_next_4u(ident_t *, int, int *, unsigned int *,
+                            unsigned int *, int *);
+int __kmpc_dispatch_next_8(ident_t *, int, int *, int64_t *, int64_t *,
+                           int64_t *);
+int __kmpc_dispatch_next_8u(ident_t *, int, int *, uint64_t *, uint64_t *,
+                            int64_t *);
+int __kmpc_reduce(ident_t *, int, int, size_t, void *,
+                  void (*)(void *, void *), kmp_critical_name *);
+void __kmpc_end_reduce(ident_t *, int, kmp_critical_name *);
+int __kmpc_reduce_nowait(ident_t *, int, int, size_t, void *,
+                         void (*)(void *, void *), kmp_critical_name *);
+void __kmpc_end_reduce_nowait(ident_t *, int, kmp_critical_name *);
 
 int __tgt_target_teams(int64_t device_id, void *host_ptr, int32_t arg_num,
                        void **args_base, void **args, int64_t *arg_sizes,
@@ -56,6 +56,9 @@
 // DQ (8/1/2005): Included Milind's AstMerge mechanism as standard part of ROSE.
 // #include "AstMerge.h"
 
+// Binary AST file I/O (writeASTToFile() and readASTFromFile()).
+#include "AST_FILE_IO.h"
+
 #ifndef ROSE_USE_INTERNAL_FRONTEND_DEVELOPMENT
 // JH (01/18/2006): adding the include file for the AST file I/O (by Jochen)
 // DQ (9/9/2007): Can't use astVisualization/ prefix since it then does not permit use from the install tree
@@ -1,6 +1,7 @@
 #ifndef ROSE_FileSystem_H
 #define ROSE_FileSystem_H
 
+#include <cstdint>
 #include <filesystem>
 #include <regex>
 #include <fstream>
@@ -217,6 +218,27 @@ void writeFile(const std::filesystem::path &fileName, const Container &data,
         MLOG_ERROR_CXX("UTIL") << "unable to write to file " << fileName.string();
 }
 
+/** Offset basis of the 64-bit FNV-1a hash. */
+const uint64_t hashOffsetBasis = 0xcbf29ce484222325ULL;
+
+/** Hash of the contents of a file.
+ *
+ *  Returns the 64-bit FNV-1a hash of @p contents, continuing from @p hash so that several strings can be hashed as one.  The
+ *  hash is the same in every process and on every host, so it can name or key files of a cache directory. */
+ROSE_UTIL_API uint64_t hashContents(const std::string &contents, uint64_t hash = hashOffsetBasis);
+
+/** Read the contents of a file.
+ *
+ *  Reads the whole file (in binary mode) into @p contents. Returns false if the file cannot be opened. */
+ROSE_UTIL_API bool readContents(const Path &fileName, std::string &contents);
+
+/** Write the contents of a file atomically.
+ *
+ *  The contents are written to a temporary file of this process next to @p fileName, which is then renamed to @p fileName,
+ *  so that other processes (e.g., concurrent runs sharing a cache directory) never read a partially written file. Returns
+ *  false if the file cannot be written, in which case the temporary file is removed and @p fileName is left as it was. */
+ROSE_UTIL_API bool writeContentsAtomically(const Path &fileName, const std::string &contents);
+
 } // namespace
 } // namespace
 
@@ -8,6 +8,11 @@
 #include "rosedll.h"
 
 ROSE_UTIL_API int systemFromVector(const std::vector<std::string>& argv);
+// Run the command lines concurrently, each as systemFromVector() would, returning their statuses in the same order.
+// At most jobs commands run at a time (0: one per hardware thread); when a GNU make jobserver is announced in MAKEFLAGS
+// each command beyond the first also holds one of its tokens.  The output of each command is held back and written
+// (to stdout and stderr) in the order of the command lines.
+ROSE_UTIL_API std::vector<int> systemFromVectors(const std::vector<std::vector<std::string> >& commandLines, int jobs);
 FILE* popenReadFromVector(const std::vector<std::string>& argv);
 // Assumes there is only one child process
 int pcloseFromVector(FILE* f);
@@ -0,0 +1,57 @@
+/*
+ * collapse(2) with long, unsigned and int induction variables: the collapsed
+ * loops of the long and unsigned indices have long long control variables and
+ * are scheduled with the _8 runtime calls, the one of the int indices with
+ * constant bounds keeps int and the _4 calls
+*/
+#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif 
+#define N 40
+#define M 30
+int a[N][M];
+
+void foo_long(long n, long m)
+{
+  long i, j;
+#pragma omp for collapse(2)
+  for (i=0;i<n;i++)
+    for (j=0;j<m;j++)
+      a[i][j]+=1;
+}
+
+void foo_unsigned(void)
+{
+  unsigned int i, j;
+#pragma omp for collapse(2) schedule(dynamic,7)
+  for (i=0;i<N;i++)
+    for (j=0;j<M;j++)
+      a[i][j]+=1;
+}
+
+void foo_int(void)
+{
+  int i, j;
+#pragma omp for collapse(2)
+  for (i=0;i<N;i++)
+    for (j=0;j<M;j++)
+      a[i][j]+=1;
+}
+
+int main(void)
+{
+  int i, j, errors = 0;
+#pragma omp parallel
+  {
+    foo_long(N,M);
+    foo_unsigned();
+    foo_int();
+  }
+  for (i=0;i<N;i++)
+    for (j=0;j<M;j++)
+      if (a[i][j]!=3)
+        errors++;
+  printf("%d wrong iteration counts\n",errors);
+  return errors!=0;
+}
@@ -0,0 +1,58 @@
+// reduction clauses in a member function and in a namespace function:
+// the generated reduce functions are inserted in the global scope
+#include <stdio.h>
+
+class Vector
+{
+  public:
+    double sum(const double *x, int n);
+};
+
+double Vector::sum(const double *x, int n)
+{
+  double s = 0.0;
+  int i;
+#pragma omp parallel for reduction(+:s)
+  for (i = 0; i < n; i++)
+    s += x[i];
+  return s;
+}
+
+struct Counter
+{
+  int count(int n)
+  {
+    int c = 0;
+    int i;
+#pragma omp parallel for reduction(+:c)
+    for (i = 0; i < n; i++)
+      c += 1;
+    return c;
+  }
+};
+
+namespace stats
+{
+  double maximum(const double *x, int n)
+  {
+    double m = x[0];
+    int i;
+#pragma omp parallel for reduction(max:m)
+    for (i = 0; i < n; i++)
+      if (x[i] > m)
+        m = x[i];
+    return m;
+  }
+}
+
+int main()
+{
+  double x[10];
+  int i;
+  for (i = 0; i < 10; i++)
+    x[i] = i;
+  Vector v;
+  Counter c;
+  printf("%f %d %f\n", v.sum(x, 10), c.count(10), stats::maximum(x, 10));
+  return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * 64-bit and unsigned loop indices, with bounds above 2^31:
+ * scheduled with the _8, _4u and _8u runtime calls
+*/
+#include <stddef.h>
+#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif 
+#define N 1000
+int a[N];
+
+void foo_long(long lower, long upper)
+{
+  long i;
+#pragma omp for
+  for (i=lower;i<upper;i++)
+    a[i-lower]+=1;
+}
+
+void foo_unsigned(unsigned int lower, unsigned int upper)
+{
+  unsigned int i;
+#pragma omp for schedule(dynamic,7)
+  for (i=lower;i<upper;i++)
+    a[i-lower]+=1;
+}
+
+void foo_size_t(size_t lower, size_t upper)
+{
+  size_t i;
+#pragma omp for schedule(static,5)
+  for (i=lower;i<upper;i++)
+    a[i-lower]+=1;
+}
+
+int main(void)
+{
+  int i, errors = 0;
+#pragma omp parallel
+  {
+    foo_long(3000000000L,3000000000L+N);
+    foo_unsigned(3000000000U,3000000000U+N);
+    foo_size_t(5000000000UL,5000000000UL+N);
+  }
+  for (i=0;i<N;i++)
+    if (a[i]!=3)
+      errors++;
+  printf("%d wrong iteration counts\n",errors);
+  return errors!=0;
+}
@@ -0,0 +1,48 @@
+/*
+ * static schedule computed in the generated code (-rose:openmp:inline_static_schedule):
+ * incremental, decremental and 64-bit loops, with and without nowait
+*/
+#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif 
+#define N 100
+int a[N];
+
+void foo(int lower, int upper, int stride)
+{
+  int i;
+#pragma omp for
+  for (i=lower;i<upper;i+=stride)
+  {
+    a[i] = omp_get_thread_num();
+  }
+}
+
+void bar(int lower, int upper)
+{
+  int i;
+#pragma omp for schedule(static) nowait
+  for (i=upper;i>=lower;i--)
+    a[i]+=1;
+}
+
+void foo_long(long lower, long upper)
+{
+  long i;
+#pragma omp for
+  for (i=lower;i<upper;i++)
+    a[i-lower]+=1;
+}
+
+int main(void)
+{
+#pragma omp parallel
+  {
+    foo(0,N,3);
+    bar(0,N-1);
+    foo_long(0,N);
+  }
+  printf("a[0] = %d\n",a[0]);
+  return 0;
+}
@@ -0,0 +1,50 @@
+#ifndef ROSE_AST_PERFORMANCE_TESTS_AST_DESCRIPTION_H
+#define ROSE_AST_PERFORMANCE_TESTS_AST_DESCRIPTION_H
+
+// Support of the tests that check that two runs of the frontend build the same AST (libastDescription).
+//
+// A test runs itself again (describe_other_run()) with another command line and the option -<test>:description
+// FILE.  That run (is_description_run()) builds its AST and writes its description to FILE (write_description()),
+// which the test compares with the description of its own AST (same_descriptions()).  The description holds each IR
+// node of a preorder traversal of the project (its class, source position and name), the number of IR nodes of each
+// variant in the memory pools and the code unparsed from each file.
+
+#include "rose.h"
+
+#include <string>
+#include <vector>
+
+// Counts the IR nodes of each variant in the memory pools (traverseMemoryPool()).
+class CountNodesByVariant : public ROSE_VisitTraversal
+   {
+     public:
+          std::vector<size_t> counts;
+          size_t total;
+
+          CountNodesByVariant();
+
+          void visit(SgNode* node);
+   };
+
+// The contents of the file (empty if it can not be read).
+std::string read_file(const std::string & filename);
+
+// The description of the AST of the project (the files are unparsed).
+std::string describe_project(SgProject* project);
+
+// True in the run started by describe_other_run(): removes -<test>:description FILE from the command line and
+// returns FILE in descriptionFile.
+bool is_description_run(std::vector<std::string> & args, const std::string & test, std::string & descriptionFile);
+
+// Writes the description of the AST of the project to the file, returns the exit status of the run.
+int write_description(SgProject* project, const std::string & descriptionFile);
+
+// Runs this program with the command line (args[0] is the program) and -<test>:description <test>_<run>.description,
+// returns the description of its AST (empty if the run failed).
+std::string describe_other_run(std::vector<std::string> args, const std::string & test, const std::string & run);
+
+// Compares the description of the AST of this run with the one of the other run, reports the first line that differs.
+bool same_descriptions(const std::string & otherDescription, const std::string & otherRun,
+                       const std::string & description, const std::string & run);
+
+#endif
@@ -0,0 +1,311 @@
+/* Input of parallelUnparser: a C file with more than 32 top level declarations (several fragments rendered ahead of
+   time), with structs, enums, typedefs, globals, functions, comments and CPP directives between them. */
+
+#include <stdio.h>
+
+#define LENGTH 8
+
+/* Record 0 */
+struct record_0
+   {
+     int key;
+     double values[LENGTH];
+     struct record_0* next;
+   };
+
+typedef struct record_0 record_0_t;
+
+enum state_0 { idle_0, busy_0 = 0 + 1 };
+
+static record_0_t table_0[LENGTH];
+
+// Sums the values of the records of table 0
+double sum_0(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_0[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_0 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 1 */
+struct record_1
+   {
+     int key;
+     double values[LENGTH];
+     struct record_1* next;
+   };
+
+typedef struct record_1 record_1_t;
+
+enum state_1 { idle_1, busy_1 = 1 + 1 };
+
+static record_1_t table_1[LENGTH];
+
+// Sums the values of the records of table 1
+double sum_1(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_1[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_1 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 2 */
+struct record_2
+   {
+     int key;
+     double values[LENGTH];
+     struct record_2* next;
+   };
+
+typedef struct record_2 record_2_t;
+
+enum state_2 { idle_2, busy_2 = 2 + 1 };
+
+static record_2_t table_2[LENGTH];
+
+// Sums the values of the records of table 2
+double sum_2(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_2[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_2 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 3 */
+struct record_3
+   {
+     int key;
+     double values[LENGTH];
+     struct record_3* next;
+   };
+
+typedef struct record_3 record_3_t;
+
+enum state_3 { idle_3, busy_3 = 3 + 1 };
+
+static record_3_t table_3[LENGTH];
+
+// Sums the values of the records of table 3
+double sum_3(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_3[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_3 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 4 */
+struct record_4
+   {
+     int key;
+     double values[LENGTH];
+     struct record_4* next;
+   };
+
+typedef struct record_4 record_4_t;
+
+enum state_4 { idle_4, busy_4 = 4 + 1 };
+
+static record_4_t table_4[LENGTH];
+
+// Sums the values of the records of table 4
+double sum_4(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_4[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_4 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 5 */
+struct record_5
+   {
+     int key;
+     double values[LENGTH];
+     struct record_5* next;
+   };
+
+typedef struct record_5 record_5_t;
+
+enum state_5 { idle_5, busy_5 = 5 + 1 };
+
+static record_5_t table_5[LENGTH];
+
+// Sums the values of the records of table 5
+double sum_5(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_5[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_5 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 6 */
+struct record_6
+   {
+     int key;
+     double values[LENGTH];
+     struct record_6* next;
+   };
+
+typedef struct record_6 record_6_t;
+
+enum state_6 { idle_6, busy_6 = 6 + 1 };
+
+static record_6_t table_6[LENGTH];
+
+// Sums the values of the records of table 6
+double sum_6(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_6[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_6 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 7 */
+struct record_7
+   {
+     int key;
+     double values[LENGTH];
+     struct record_7* next;
+   };
+
+typedef struct record_7 record_7_t;
+
+enum state_7 { idle_7, busy_7 = 7 + 1 };
+
+static record_7_t table_7[LENGTH];
+
+// Sums the values of the records of table 7
+double sum_7(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_7[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_7 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 8 */
+struct record_8
+   {
+     int key;
+     double values[LENGTH];
+     struct record_8* next;
+   };
+
+typedef struct record_8 record_8_t;
+
+enum state_8 { idle_8, busy_8 = 8 + 1 };
+
+static record_8_t table_8[LENGTH];
+
+// Sums the values of the records of table 8
+double sum_8(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_8[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_8 = %f\n", s);
+#endif
+     return s;
+   }
+
+/* Record 9 */
+struct record_9
+   {
+     int key;
+     double values[LENGTH];
+     struct record_9* next;
+   };
+
+typedef struct record_9 record_9_t;
+
+enum state_9 { idle_9, busy_9 = 9 + 1 };
+
+static record_9_t table_9[LENGTH];
+
+// Sums the values of the records of table 9
+double sum_9(int n)
+   {
+     double s = 0.0;
+     int k, m;
+     for (k = 0; k < n && k < LENGTH; k++)
+        {
+          for (m = 0; m < LENGTH; m++)
+               s += table_9[k].values[m];
+        }
+#ifdef VERBOSE
+     printf("sum_9 = %f\n", s);
+#endif
+     return s;
+   }
+
+int main()
+   {
+     return sum_0(LENGTH) + sum_9(LENGTH) == 0.0 ? 0 : 1;
+   }
@@ -1,3 +1,4 @@
+#include <stdint.h>
 
 typedef struct ident {
     int reserved_1;
@@ -7,17 +8,32 @@ typedef struct ident {
     char const *psource;
 } ident_t;
 
+typedef int kmp_critical_name[8];
+
 void __kmpc_fork_call(ident_t*, int, void*, ...);
 void __kmpc_atomic_start(void);
 void __kmpc_atomic_end(void);
 void __kmpc_push_num_threads(ident_t*, int, int);
 int __kmpc_global_thread_num(ident_t*);
+int omp_get_num_threads(void);
+int omp_get_thread_num(void);
 int __kmpc_single(ident_t*, int);
 void __kmpc_end_single(ident_t*, int);
 void __kmpc_barrier(ident_t*, int);
 int __kmpc_serialized_parallel(ident_t*, int);
 void __kmpc_end_serialized_parallel(ident_t*, int);
 void __kmpc_for_static_init_4(ident_t*, int, int, int*, int*, int*, int*, int, int);
+void __kmpc_for_static_init_4u(ident_t*, int, int, int*, unsigned int*, unsigned int*, int*, int, int);
+void __kmpc_for_static_init_8(ident_t*, int, int, int*, int64_t*, int64_t*, int64_t*, int64_t, int64_t);
+void __kmpc_for_static_init_8u(ident_t*, int, int, int*, uint64_t*, uint64_t*, int64_t*, int64_t, int64_t);
 void __kmpc_for_static_fini(ident_t*, int);
 void __kmpc_dispatch_init_4(ident_t*, int, int, int, int, int, int);
+void __kmpc_dispatch_init_4u(ident_t*, int, int, unsigned int, unsigned int, int, int);
+void __kmpc_dispatch_init_8(ident_t*, int, int, int64_t, int64_t, int64_t, int64_t);
+void __kmpc_dispatch_init_8u(ident_t*, int, int, uint64_t, uint64_t, int64_t, int64_t);
 int __kmpc_dispatch_next_4(ident_t*, int, int*, int*, int*, int*);
+int __kmpc_dispatch_next_4u(ident_t*, int, int*, unsigned int*, unsigned int*, int*);
+int __kmpc_dispatch_next_8(ident_t*, int, int*, int64_t*, int64_t*, int64_t*);
+int __kmpc_dispatch_next_8u(ident_t*, int, int*, uint64_t*, uint64_t*, int64_t*);
+int __kmpc_reduce_nowait(ident_t*, int, int, unsigned long, void*, void (*)(void*, void*), kmp_critical_name*);
+void __kmpc_end_reduce_nowait(ident_t*, int, kmp_critical_name*);
@@ -0,0 +1,104 @@
+/*
+ * 64-bit and unsigned loop indices, with bounds above 2^31:
+ * scheduled with the _8, _4u and _8u runtime calls
+*/
+#include <stddef.h>
+#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif 
+#include "rex_kmp.h" 
+int a[1000];
+
+void foo_long(long lower,long upper)
+{
+  long i;
+{
+    long _p_i;
+    int64_t __index_;
+    int64_t __lower_ = lower;
+    int64_t __upper_ = upper - 1;
+    int64_t __stride_ = 1;
+    int __last_iter_ = 0;
+    __kmpc_for_static_init_8(0,(__kmpc_global_thread_num(0)),34,&__last_iter_,&__lower_,&__upper_,&__stride_,1,1);
+    if (__upper_ > upper - 1) 
+      __upper_ = upper - 1;
+    for (__index_ = __lower_; __index_ <= __upper_; __index_ += 1) {
+      a[__index_ - lower] += 1;
+    }
+    __kmpc_for_static_fini(0,(__kmpc_global_thread_num(0)));
+    __kmpc_barrier(0,(__kmpc_global_thread_num(0)));
+  }
+}
+
+void foo_unsigned(unsigned int lower,unsigned int upper)
+{
+  unsigned int i;
+{
+    unsigned int _p_i;
+    unsigned int __index_;
+    unsigned int __lower_ = lower;
+    unsigned int __upper_ = upper - 1;
+    int __stride_ = 1;
+    int __last_iter_ = 0;
+    __kmpc_dispatch_init_4u(0,(__kmpc_global_thread_num(0)),1073741859,__lower_,__upper_,__stride_,7);
+{
+      while(__kmpc_dispatch_next_4u(0,(__kmpc_global_thread_num(0)),&__last_iter_,&__lower_,&__upper_,&__stride_)){
+        if (__upper_ > upper - 1) 
+          __upper_ = upper - 1;
+        for (__index_ = __lower_; __index_ <= __upper_; __index_ += 1) {
+          a[__index_ - lower] += 1;
+        }
+      }
+    }
+    __kmpc_barrier(0,(__kmpc_global_thread_num(0)));
+  }
+}
+
+void foo_size_t(size_t lower,size_t upper)
+{
+  size_t i;
+{
+    size_t _p_i;
+    uint64_t __index_;
+    uint64_t __lower_ = lower;
+    uint64_t __upper_ = upper - 1;
+    int64_t __stride_ = 1;
+    int __last_iter_ = 0;
+    __kmpc_for_static_init_8u(0,(__kmpc_global_thread_num(0)),33,&__last_iter_,&__lower_,&__upper_,&__stride_,1,5);
+{
+      while(__lower_ <= __upper_){
+        if (__upper_ > upper - 1) 
+          __upper_ = upper - 1;
+        for (__index_ = __lower_; __index_ <= __upper_; __index_ += 1) {
+          a[__index_ - lower] += 1;
+        }
+        __lower_ += __stride_;
+        __upper_ += __stride_;
+      }
+    }
+    __kmpc_for_static_fini(0,(__kmpc_global_thread_num(0)));
+    __kmpc_barrier(0,(__kmpc_global_thread_num(0)));
+  }
+}
+static void OUT__1__3901__(int *__global_tid,int *__bound_tid,void *__out_argv);
+
+int main(int argc,char **argv)
+{
+  int status = 0;
+  int i;
+  int errors = 0;
+  __kmpc_fork_call(0,1,OUT__1__3901__,0);
+  for (i = 0; i < 1000; i++) 
+    if (a[i] != 3) 
+      errors++;
+  printf("%d wrong iteration counts\n",errors);
+  return errors != 0;
+}
+
+static void OUT__1__3901__(int *__global_tid,int *__bound_tid,void *__out_argv)
+{
+  foo_long(3000000000L,3000000000L + 1000);
+  foo_unsigned(3000000000U,3000000000U + 1000);
+  foo_size_t(5000000000UL,5000000000UL + 1000);
+}
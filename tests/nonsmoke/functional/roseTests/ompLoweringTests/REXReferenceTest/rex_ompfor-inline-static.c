@@ -0,0 +1,115 @@
+/*
+ * static schedule computed in the generated code (-rose:openmp:inline_static_schedule):
+ * incremental, decremental and 64-bit loops, with and without nowait
+*/
+#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif 
+#include "rex_kmp.h" 
+int a[100];
+
+void foo(int lower,int upper,int stride)
+{
+  int i;
+{
+    int _p_i;
+    int __index_;
+    int __lower_ = lower;
+    int __upper_ = upper - 1;
+    int __stride_ = stride;
+    int __num_threads_ = omp_get_num_threads();
+    int __thread_id_ = omp_get_thread_num();
+    if (__lower_ <= __upper_) {
+      int __iter_count_ = (__upper_ - __lower_) / __stride_ + 1;
+      int __chunk_size_ = __iter_count_ / __num_threads_;
+      int __chunk_remainder_ = __iter_count_ % __num_threads_;
+      int __chunk_offset_ = __chunk_size_ * __thread_id_ + __chunk_remainder_;
+      if (__thread_id_ < __chunk_remainder_) {
+        __chunk_size_ += 1;
+        __chunk_offset_ = __chunk_size_ * __thread_id_;
+      }
+      __lower_ += __chunk_offset_ * __stride_;
+      __upper_ = __lower_ + (__chunk_size_ - 1) * __stride_;
+    }
+    for (__index_ = __lower_; __index_ <= __upper_; __index_ += stride) {
+      a[__index_] = omp_get_thread_num();
+    }
+    __kmpc_barrier(0,(__kmpc_global_thread_num(0)));
+  }
+}
+
+void bar(int lower,int upper)
+{
+  int i;
+{
+    int _p_i;
+    int __index_;
+    int __lower_ = upper;
+    int __upper_ = lower;
+    int __stride_ = -1;
+    int __num_threads_ = omp_get_num_threads();
+    int __thread_id_ = omp_get_thread_num();
+    if (__lower_ >= __upper_) {
+      int __iter_count_ = (__lower_ - __upper_) / -__stride_ + 1;
+      int __chunk_size_ = __iter_count_ / __num_threads_;
+      int __chunk_remainder_ = __iter_count_ % __num_threads_;
+      int __chunk_offset_ = __chunk_size_ * __thread_id_ + __chunk_remainder_;
+      if (__thread_id_ < __chunk_remainder_) {
+        __chunk_size_ += 1;
+        __chunk_offset_ = __chunk_size_ * __thread_id_;
+      }
+      __lower_ += __chunk_offset_ * __stride_;
+      __upper_ = __lower_ + (__chunk_size_ - 1) * __stride_;
+    }
+    for (__index_ = __lower_; __index_ >= __upper_; __index_ += -1) {
+      a[__index_] += 1;
+    }
+  }
+}
+
+void foo_long(long lower,long upper)
+{
+  long i;
+{
+    long _p_i;
+    int64_t __index_;
+    int64_t __lower_ = lower;
+    int64_t __upper_ = upper - 1;
+    int64_t __stride_ = 1;
+    int __num_threads_ = omp_get_num_threads();
+    int __thread_id_ = omp_get_thread_num();
+    if (__lower_ <= __upper_) {
+      int64_t __iter_count_ = (__upper_ - __lower_) / __stride_ + 1;
+      int64_t __chunk_size_ = __iter_count_ / __num_threads_;
+      int64_t __chunk_remainder_ = __iter_count_ % __num_threads_;
+      int64_t __chunk_offset_ = __chunk_size_ * __thread_id_ + __chunk_remainder_;
+      if (__thread_id_ < __chunk_remainder_) {
+        __chunk_size_ += 1;
+        __chunk_offset_ = __chunk_size_ * __thread_id_;
+      }
+      __lower_ += __chunk_offset_ * __stride_;
+      __upper_ = __lower_ + (__chunk_size_ - 1) * __stride_;
+    }
+    for (__index_ = __lower_; __index_ <= __upper_; __index_ += 1) {
+      a[__index_ - lower] += 1;
+    }
+    __kmpc_barrier(0,(__kmpc_global_thread_num(0)));
+  }
+}
+static void OUT__1__4808__(int *__global_tid,int *__bound_tid,void *__out_argv);
+
+int main(int argc,char **argv)
+{
+  int status = 0;
+  __kmpc_fork_call(0,1,OUT__1__4808__,0);
+  printf("a[0] = %d\n",a[0]);
+  return 0;
+}
+
+static void OUT__1__4808__(int *__global_tid,int *__bound_tid,void *__out_argv)
+{
+  foo(0,100,3);
+  bar(0,100 - 1);
+  foo_long(0,100);
+}
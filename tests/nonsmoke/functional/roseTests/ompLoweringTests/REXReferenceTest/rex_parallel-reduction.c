@@ -3,6 +3,11 @@
 #include<stdio.h> 
 #include "rex_kmp.h" 
 
+static void __rex_reduce_main_9_0(void *__lhs,void *__rhs)
+{
+   *((int *)(((void **)__lhs)[0])) =  *((int *)(((void **)__lhs)[0])) +  *((int *)(((void **)__rhs)[0]));
+}
+
 struct OUT__1__4635___data 
 {
   void *i_p;
@@ -48,7 +53,21 @@ static void OUT__1__4635__(int *__global_tid,int *__bound_tid,void *__out_argv)
   }
   __kmpc_barrier(0, *__global_tid);
   _p_sum +=  *i;
-  __kmpc_atomic_start();
-   *sum =  *sum + _p_sum;
-  __kmpc_atomic_end();
+  int __global_tid_main_9_0 = __kmpc_global_thread_num(0);
+  static ident_t __rex_reduction_loc = {0, 0x12, 0, 0, ";unknown;unknown;0;0;;"};
+  static int __rex_reduction_lock[8];
+  void *__rex_reduction_list[1] = {(&_p_sum)};
+  switch(__kmpc_reduce_nowait(&__rex_reduction_loc,__global_tid_main_9_0,1,sizeof(__rex_reduction_list),__rex_reduction_list,__rex_reduce_main_9_0,&__rex_reduction_lock)){
+    case 1:
+{
+       *sum =  *sum + _p_sum;
+      __kmpc_end_reduce_nowait(&__rex_reduction_loc,__global_tid_main_9_0,&__rex_reduction_lock);
+      break; 
+    }
+    case 2:
+{
+      __atomic_fetch_add(& *sum,_p_sum,__ATOMIC_RELAXED);
+      break; 
+    }
+  }
 }
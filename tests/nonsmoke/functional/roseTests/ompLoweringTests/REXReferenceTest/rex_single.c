@@ -40,9 +40,7 @@ static void OUT__1__3414__(int *__global_tid,int *__bound_tid,void *__out_argv)
   int *num_threads = (int *)(((struct OUT__1__3414___data *)__out_argv) -> num_threads_p);
   if (__kmpc_single(0, *__global_tid)) {{
        *num_threads = omp_get_num_threads();
-      __kmpc_atomic_start();
-       *i += 100;
-      __kmpc_atomic_end();
+      __atomic_fetch_add(i,100,__ATOMIC_RELAXED);
     }
     __kmpc_end_single(0, *__global_tid);
   }
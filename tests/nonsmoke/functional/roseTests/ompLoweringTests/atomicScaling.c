@@ -0,0 +1,168 @@
+/*
+ * Thread scaling of the lowered atomic updates and reductions.
+ *
+ * Histograms of N values into BINS bins with omp atomic (int and double bins,
+ * so every thread updates the same few locations) and sums with a reduction
+ * clause (of one variable, then of two variables combined by one call to the
+ * runtime), run with 1, 2, 4, ... up to omp_get_max_threads() threads. The time
+ * of each kernel is printed for each number of threads, and the results are
+ * checked against the serial ones.
+ *
+ * make atomic_scaling  lowers it with roseomp, builds it with the LLVM OpenMP
+ * runtime (KMP_LINK) and runs it, then builds the same source with
+ * $(CC) -fopenmp and runs it, so both timings are reported.
+ */
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N 4000000
+#define BINS 16
+#define ROUNDS 5
+
+int data[N];
+int hist[BINS];
+double whist[BINS];
+
+void histogram(void)
+{
+  int i;
+#pragma omp parallel for
+  for (i = 0; i < N; i++)
+  {
+#pragma omp atomic
+    hist[data[i] % BINS]++;
+  }
+}
+
+void weighted_histogram(void)
+{
+  int i;
+#pragma omp parallel for
+  for (i = 0; i < N; i++)
+  {
+#pragma omp atomic
+    whist[data[i] % BINS] += data[i] % 7;
+  }
+}
+
+long sum_int(void)
+{
+  int i;
+  long sum = 0;
+#pragma omp parallel for reduction(+:sum)
+  for (i = 0; i < N; i++)
+    sum += data[i];
+  return sum;
+}
+
+double sum_double(void)
+{
+  int i;
+  double sum = 0.0;
+#pragma omp parallel for reduction(+:sum)
+  for (i = 0; i < N; i++)
+    sum += data[i] % 7;
+  return sum;
+}
+
+double sum_both(long *sum)
+{
+  int i;
+  long sum_int = 0;
+  double sum_double = 0.0;
+#pragma omp parallel for reduction(+:sum_int, sum_double)
+  for (i = 0; i < N; i++)
+  {
+    sum_int += data[i];
+    sum_double += data[i] % 7;
+  }
+  *sum = sum_int;
+  return sum_double;
+}
+
+int main(void)
+{
+  int i, k, round, threads;
+  int max_threads = omp_get_max_threads();
+  int ref_hist[BINS];
+  double ref_whist[BINS];
+  long ref_sum_int = 0;
+  double ref_sum_double = 0.0;
+  int errors = 0;
+
+  for (k = 0; k < BINS; k++)
+  {
+    ref_hist[k] = 0;
+    ref_whist[k] = 0.0;
+  }
+  srand(1);
+  for (i = 0; i < N; i++)
+  {
+    data[i] = rand() % 1000;
+    ref_hist[data[i] % BINS]++;
+    ref_whist[data[i] % BINS] += data[i] % 7;
+    ref_sum_int += data[i];
+    ref_sum_double += data[i] % 7;
+  }
+
+  printf("%8s %14s %14s %14s %14s %14s\n", "threads", "histogram", "weighted",
+         "sum int", "sum double", "sum both");
+  for (threads = 1; threads <= max_threads; threads *= 2)
+  {
+    double t_hist = 0.0, t_whist = 0.0, t_sum_int = 0.0, t_sum_double = 0.0;
+    double t_sum_both = 0.0;
+    double start;
+    omp_set_num_threads(threads);
+    for (round = 0; round < ROUNDS; round++)
+    {
+      long s_int, s_both_int;
+      double s_double, s_both_double;
+      for (k = 0; k < BINS; k++)
+      {
+        hist[k] = 0;
+        whist[k] = 0.0;
+      }
+
+      start = omp_get_wtime();
+      histogram();
+      t_hist += omp_get_wtime() - start;
+
+      start = omp_get_wtime();
+      weighted_histogram();
+      t_whist += omp_get_wtime() - start;
+
+      start = omp_get_wtime();
+      s_int = sum_int();
+      t_sum_int += omp_get_wtime() - start;
+
+      start = omp_get_wtime();
+      s_double = sum_double();
+      t_sum_double += omp_get_wtime() - start;
+
+      start = omp_get_wtime();
+      s_both_double = sum_both(&s_both_int);
+      t_sum_both += omp_get_wtime() - start;
+
+      for (k = 0; k < BINS; k++)
+      {
+        if (hist[k] != ref_hist[k] || whist[k] != ref_whist[k])
+          errors++;
+      }
+      if (s_int != ref_sum_int || s_double != ref_sum_double)
+        errors++;
+      if (s_both_int != ref_sum_int || s_both_double != ref_sum_double)
+        errors++;
+    }
+    printf("%8d %14.6f %14.6f %14.6f %14.6f %14.6f\n", threads, t_hist / ROUNDS,
+           t_whist / ROUNDS, t_sum_int / ROUNDS, t_sum_double / ROUNDS,
+           t_sum_both / ROUNDS);
+  }
+
+  if (errors != 0)
+  {
+    printf("%d wrong results\n", errors);
+    return 1;
+  }
+  return 0;
+}
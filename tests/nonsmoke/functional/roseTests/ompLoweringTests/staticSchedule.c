@@ -0,0 +1,108 @@
+/*
+ * Cost of entering small loops with the static schedule.
+ *
+ * Inside one parallel region, omp for loops of N iterations (incremental,
+ * decremental with a stride of 3, over unsigned and long indices, and with a
+ * lastprivate variable) are entered ROUNDS times each. The time per entry of
+ * each loop is printed, and every iteration is checked to have run exactly
+ * once per round.
+ *
+ * make static_schedule  lowers it with roseomp twice, calling the runtime
+ * (__kmpc_for_static_init) and with -rose:openmp:inline_static_schedule, builds
+ * both with the LLVM OpenMP runtime (KMP_LINK) and runs them.
+ */
+#include <omp.h>
+#include <stdio.h>
+
+#define N 64
+#define ROUNDS 200000
+
+int counts[N];
+double a[N], b[N];
+
+int main(void)
+{
+  int j, k;
+  int errors = 0;
+  int last = -1;
+  double t_inc = 0.0, t_dec = 0.0, t_unsigned = 0.0, t_long = 0.0;
+  double t_lastprivate = 0.0;
+
+  for (k = 0; k < N; k++)
+  {
+    a[k] = k;
+    b[k] = 0.0;
+  }
+
+#pragma omp parallel
+  {
+    int round;
+    double start;
+    for (round = 0; round < ROUNDS; round++)
+    {
+      int i;
+      unsigned int u;
+      long l;
+
+      start = omp_get_wtime();
+#pragma omp for
+      for (i = 0; i < N; i++)
+        b[i] = 2.0 * a[i] + b[i];
+#pragma omp master
+      t_inc += omp_get_wtime() - start;
+
+      start = omp_get_wtime();
+#pragma omp for
+      for (i = N - 1; i >= 0; i -= 3)
+        counts[i]++;
+#pragma omp master
+      t_dec += omp_get_wtime() - start;
+
+      start = omp_get_wtime();
+#pragma omp for
+      for (u = 0; u < N; u++)
+        counts[u]++;
+#pragma omp master
+      t_unsigned += omp_get_wtime() - start;
+
+      start = omp_get_wtime();
+#pragma omp for
+      for (l = 0; l < N; l++)
+        counts[l]++;
+#pragma omp master
+      t_long += omp_get_wtime() - start;
+
+      start = omp_get_wtime();
+#pragma omp for lastprivate(j)
+      for (j = 0; j < N; j++)
+        counts[j]++;
+#pragma omp master
+      {
+        t_lastprivate += omp_get_wtime() - start;
+        last = j;
+      }
+    }
+  }
+
+  for (k = 0; k < N; k++)
+  {
+    int expected = (N - 1 - k) % 3 == 0 ? 4 * ROUNDS : 3 * ROUNDS;
+    if (counts[k] != expected || b[k] != 2.0 * k * ROUNDS)
+      errors++;
+  }
+  if (last != N)
+    errors++;
+
+  printf("%8s %14s %14s %14s %14s %14s\n", "threads", "incremental",
+         "decremental", "unsigned", "long", "lastprivate");
+  printf("%8d %14.3e %14.3e %14.3e %14.3e %14.3e\n", omp_get_max_threads(),
+         t_inc / ROUNDS, t_dec / ROUNDS, t_unsigned / ROUNDS, t_long / ROUNDS,
+         t_lastprivate / ROUNDS);
+
+  if (errors != 0)
+  {
+    printf("%d wrong results\n", errors);
+    return 1;
+  }
+  return 0;
+}